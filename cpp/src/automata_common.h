@@ -0,0 +1,36 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+// Shared constants and coordinate helpers for the native steppers. Values mirror the
+// EDGE_* constants in scripts/main.gd.
+
+namespace automata {
+
+constexpr int EDGE_WRAP = 0;
+constexpr int EDGE_BOUNCE = 1;
+constexpr int EDGE_FALLOFF = 2;
+// Unbounded plane; only SparseWorld supports it (the dense steppers treat it like falloff).
+constexpr int EDGE_INFINITE = 3;
+
+inline int clamp_axis(int value, int max_value) {
+    return std::clamp(value, 0, max_value - 1);
+}
+
+inline int wrap_axis(int value, int max_value) {
+    int m = value % max_value;
+    return m < 0 ? m + max_value : m;
+}
+
+inline int bounce_axis(int value, int max_value) {
+    if (value < 0) {
+        return clamp_axis(-value - 1, max_value);
+    }
+    if (value >= max_value) {
+        return clamp_axis(max_value - (value - max_value) - 1, max_value);
+    }
+    return value;
+}
+
+} // namespace automata
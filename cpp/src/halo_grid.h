@@ -0,0 +1,100 @@
+#pragma once
+
+#include "automata_common.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Grid copy surrounded by a ring of ghost cells.
+//
+// refresh() fills the ring once per step from the interior according to the edge mode (wrap:
+// opposite side, bounce: mirrored, falloff: zero), after which a stencil can read x - halo ..
+// x + halo and y - halo .. y + halo for every interior cell without checking bounds. Rows are
+// addressed in interior coordinates: row(-1) is the top ghost row, row(y)[-1] the left ghost cell.
+
+namespace automata {
+
+template <typename T>
+class HaloGrid {
+public:
+    // Contents are unspecified until the next load() and refresh(), which overwrite every cell.
+    void resize(int p_width, int p_height, int p_halo = 1) {
+        width = p_width;
+        height = p_height;
+        halo = p_halo;
+        stride = width + 2 * halo;
+        cells.resize(static_cast<size_t>(stride) * (height + 2 * halo));
+    }
+
+    int get_width() const { return width; }
+    int get_height() const { return height; }
+    int get_stride() const { return stride; }
+
+    T *row(int y) { return cells.data() + static_cast<int64_t>(y + halo) * stride + halo; }
+    const T *row(int y) const { return cells.data() + static_cast<int64_t>(y + halo) * stride + halo; }
+
+    // Copies a dense width x height grid into the interior.
+    void load(const T *src) {
+        for (int y = 0; y < height; y++) {
+            memcpy(row(y), src + static_cast<int64_t>(y) * width, sizeof(T) * width);
+        }
+    }
+
+    void store(T *dst) const {
+        for (int y = 0; y < height; y++) {
+            memcpy(dst + static_cast<int64_t>(y) * width, row(y), sizeof(T) * width);
+        }
+    }
+
+    void refresh(int edge_mode) {
+        // Side ghosts of interior rows first, so copying whole rows below also fills the corners.
+        for (int y = 0; y < height; y++) {
+            T *r = row(y);
+            for (int k = 1; k <= halo; k++) {
+                r[-k] = sample(r, -k, width, edge_mode);
+                r[width - 1 + k] = sample(r, width - 1 + k, width, edge_mode);
+            }
+        }
+        for (int k = 1; k <= halo; k++) {
+            fill_ghost_row(-k, edge_mode);
+            fill_ghost_row(height - 1 + k, edge_mode);
+        }
+    }
+
+private:
+    static T sample(const T *r, int x, int size, int edge_mode) {
+        switch (edge_mode) {
+            case EDGE_WRAP:
+                return r[wrap_axis(x, size)];
+            case EDGE_BOUNCE:
+                return r[bounce_axis(x, size)];
+            default:
+                return T();
+        }
+    }
+
+    void fill_ghost_row(int y, int edge_mode) {
+        T *dst = row(y) - halo;
+        switch (edge_mode) {
+            case EDGE_WRAP:
+                memcpy(dst, row(wrap_axis(y, height)) - halo, sizeof(T) * stride);
+                break;
+            case EDGE_BOUNCE:
+                memcpy(dst, row(bounce_axis(y, height)) - halo, sizeof(T) * stride);
+                break;
+            default:
+                std::fill(dst, dst + stride, T());
+                break;
+        }
+    }
+
+    std::vector<T> cells;
+    int width = 0;
+    int height = 0;
+    int halo = 1;
+    int stride = 0;
+};
+
+} // namespace automata
@@ -0,0 +1,370 @@
+#include "hashlife.h"
+
+#include <algorithm>
+
+namespace automata {
+
+HashLife::HashLife() {
+    set_rule(birth_mask, survive_mask);
+    clear();
+}
+
+bool HashLife::set_rule(uint16_t p_birth_mask, uint16_t p_survive_mask) {
+    if (p_birth_mask & 1) {
+        return false;
+    }
+    birth_mask = p_birth_mask;
+    survive_mask = p_survive_mask;
+
+    // 4x4 block (bit r * 4 + c) -> next state of its center 2x2 as nw | ne << 1 | sw << 2 | se << 3.
+    for (uint32_t block = 0; block < (1u << 16); block++) {
+        uint8_t next = 0;
+        for (int i = 0; i < 4; i++) {
+            const int r = 1 + (i >> 1);
+            const int c = 1 + (i & 1);
+            int count = 0;
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    if (dr != 0 || dc != 0) {
+                        count += (block >> ((r + dr) * 4 + c + dc)) & 1;
+                    }
+                }
+            }
+            const bool alive = (block >> (r * 4 + c)) & 1;
+            const uint16_t mask = alive ? survive_mask : birth_mask;
+            next |= static_cast<uint8_t>(((mask >> count) & 1) << i);
+        }
+        base_table[block] = next;
+    }
+    invalidate_results();
+    return true;
+}
+
+void HashLife::clear() {
+    nodes.clear();
+    free_nodes.clear();
+    empties.clear();
+    buckets.assign(1024, NONE);
+    live_nodes = 0;
+
+    // Index 0 is the dead cell and index 1 the live cell; both are level 0 leaves.
+    Node dead;
+    Node alive;
+    alive.population = 1;
+    nodes.push_back(dead);
+    nodes.push_back(alive);
+    live_nodes = 2;
+    empties.push_back(0);
+    for (uint32_t i = 0; i < 16; i++) {
+        level1[i] = join(i & 1, (i >> 1) & 1, (i >> 2) & 1, (i >> 3) & 1);
+    }
+
+    root = empty(3);
+    generation = 0;
+}
+
+uint64_t HashLife::hash_children(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+    uint64_t h = nw * 0x9E3779B97F4A7C15ULL;
+    h = (h ^ (h >> 29) ^ ne) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 31) ^ sw) * 0x94D049BB133111EBULL;
+    h = (h ^ (h >> 30) ^ se) * 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 32);
+}
+
+uint32_t HashLife::join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+    const size_t bucket = hash_children(nw, ne, sw, se) & (buckets.size() - 1);
+    for (uint32_t i = buckets[bucket]; i != NONE; i = nodes[i].next_in_bucket) {
+        const Node &n = nodes[i];
+        if (n.nw == nw && n.ne == ne && n.sw == sw && n.se == se) {
+            stats.join_hits++;
+            return i;
+        }
+    }
+    stats.join_misses++;
+
+    Node n;
+    n.nw = nw;
+    n.ne = ne;
+    n.sw = sw;
+    n.se = se;
+    n.level = static_cast<uint8_t>(nodes[nw].level + 1);
+    n.population = nodes[nw].population + nodes[ne].population + nodes[sw].population + nodes[se].population;
+    n.next_in_bucket = buckets[bucket];
+
+    uint32_t index;
+    if (!free_nodes.empty()) {
+        index = free_nodes.back();
+        free_nodes.pop_back();
+        nodes[index] = n;
+    } else {
+        index = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(n);
+    }
+    buckets[bucket] = index;
+    live_nodes++;
+    if (live_nodes > buckets.size()) {
+        rehash(buckets.size() * 2);
+    }
+    return index;
+}
+
+uint32_t HashLife::empty(int level) {
+    while (static_cast<int>(empties.size()) <= level) {
+        const uint32_t e = empties.back();
+        empties.push_back(join(e, e, e, e));
+    }
+    return empties[level];
+}
+
+uint32_t HashLife::center(uint32_t node) {
+    const Node n = nodes[node];
+    return join(nodes[n.nw].se, nodes[n.ne].sw, nodes[n.sw].ne, nodes[n.se].nw);
+}
+
+uint32_t HashLife::expand(uint32_t node) {
+    const Node n = nodes[node];
+    const uint32_t e = empty(n.level - 1);
+    return join(join(e, e, e, n.nw), join(e, e, n.ne, e), join(e, n.sw, e, e), join(n.se, e, e, e));
+}
+
+bool HashLife::fits_inner_quarter(uint32_t node) const {
+    const Node &n = nodes[node];
+    const uint64_t inner = nodes[nodes[nodes[n.nw].se].se].population + nodes[nodes[nodes[n.ne].sw].sw].population +
+                           nodes[nodes[nodes[n.sw].ne].ne].population + nodes[nodes[nodes[n.se].nw].nw].population;
+    return inner == n.population;
+}
+
+uint32_t HashLife::base_successor(uint32_t node) {
+    const Node &n = nodes[node];
+    auto quad = [&](uint32_t child) {
+        const Node &c = nodes[child];
+        return c.nw | (c.ne << 1) | (c.sw << 4) | (c.se << 5);
+    };
+    const uint32_t block = quad(n.nw) | (quad(n.ne) << 2) | (quad(n.sw) << 8) | (quad(n.se) << 10);
+    return level1[base_table[block]];
+}
+
+// Center of `node` (one level down) advanced 2^min(step_log2, level - 2) generations.
+uint32_t HashLife::successor(uint32_t node) {
+    const Node &cached = nodes[node];
+    const int level = cached.level;
+    if (cached.population == 0) {
+        return empty(level - 1);
+    }
+    if (cached.result != NONE && cached.result_epoch == epoch) {
+        stats.result_hits++;
+        return cached.result;
+    }
+    stats.result_misses++;
+
+    uint32_t result;
+    if (level == 2) {
+        result = base_successor(node);
+    } else {
+        // Copy out the grandchildren first: join() may grow `nodes` and move it.
+        const Node n = nodes[node];
+        const Node nw = nodes[n.nw];
+        const Node ne = nodes[n.ne];
+        const Node sw = nodes[n.sw];
+        const Node se = nodes[n.se];
+
+        uint32_t parts[9] = {
+            n.nw,
+            join(nw.ne, ne.nw, nw.se, ne.sw),
+            n.ne,
+            join(nw.sw, nw.se, sw.nw, sw.ne),
+            join(nw.se, ne.sw, sw.ne, se.nw),
+            join(ne.sw, ne.se, se.nw, se.ne),
+            n.sw,
+            join(sw.ne, se.nw, sw.se, se.sw),
+            n.se,
+        };
+        // At full speed both halves advance; otherwise the first half only re-centers.
+        const bool full_speed = step_log2 >= level - 2;
+        for (uint32_t &part : parts) {
+            part = full_speed ? successor(part) : center(part);
+        }
+        result = join(successor(join(parts[0], parts[1], parts[3], parts[4])),
+                successor(join(parts[1], parts[2], parts[4], parts[5])),
+                successor(join(parts[3], parts[4], parts[6], parts[7])),
+                successor(join(parts[4], parts[5], parts[7], parts[8])));
+    }
+
+    Node &stored = nodes[node];
+    stored.result = result;
+    stored.result_epoch = epoch;
+    return result;
+}
+
+bool HashLife::set_step_log2(int p_step_log2) {
+    if (p_step_log2 < 0 || p_step_log2 > MAX_STEP_LOG2) {
+        return false;
+    }
+    if (p_step_log2 != step_log2) {
+        step_log2 = p_step_log2;
+        invalidate_results();
+    }
+    return true;
+}
+
+void HashLife::invalidate_results() {
+    epoch++;
+    if (epoch == 0) {
+        for (Node &n : nodes) {
+            n.result = NONE;
+        }
+        epoch = 1;
+    }
+}
+
+bool HashLife::step() {
+    if (max_nodes > 0 && live_nodes > max_nodes) {
+        collect_garbage();
+    }
+    // The pattern must sit in the central quarter of a root at least step + 3 levels deep so that
+    // nothing can travel past the result square within 2^step generations.
+    while (nodes[root].level < step_log2 + 3 || !fits_inner_quarter(root)) {
+        if (nodes[root].level >= MAX_LEVEL) {
+            return false;
+        }
+        root = expand(root);
+    }
+    root = successor(root);
+    generation += 1ULL << step_log2;
+    return true;
+}
+
+uint64_t HashLife::get_population() const {
+    return nodes[root].population;
+}
+
+int HashLife::get_root_level() const {
+    return nodes[root].level;
+}
+
+uint32_t HashLife::build(const uint8_t *cells, int width, int height, int64_t x, int64_t y, int level, int64_t x0, int64_t y0) {
+    const int64_t size = int64_t(1) << level;
+    if (x0 >= x + width || y0 >= y + height || x0 + size <= x || y0 + size <= y) {
+        return empty(level);
+    }
+    if (level == 0) {
+        return cells[(y0 - y) * width + (x0 - x)] != 0 ? 1 : 0;
+    }
+    const int64_t half = size >> 1;
+    const uint32_t nw = build(cells, width, height, x, y, level - 1, x0, y0);
+    const uint32_t ne = build(cells, width, height, x, y, level - 1, x0 + half, y0);
+    const uint32_t sw = build(cells, width, height, x, y, level - 1, x0, y0 + half);
+    const uint32_t se = build(cells, width, height, x, y, level - 1, x0 + half, y0 + half);
+    return join(nw, ne, sw, se);
+}
+
+void HashLife::load(const uint8_t *cells, int width, int height, int64_t x, int64_t y) {
+    clear();
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    int level = 3;
+    while (true) {
+        const int64_t half = int64_t(1) << (level - 1);
+        if (x >= -half && y >= -half && x + width <= half && y + height <= half) {
+            break;
+        }
+        level++;
+    }
+    const int64_t half = int64_t(1) << (level - 1);
+    root = build(cells, width, height, x, y, level, -half, -half);
+}
+
+void HashLife::read_node(uint32_t node, uint8_t *out, int64_t x, int64_t y, int width, int height, int64_t x0, int64_t y0) const {
+    const Node &n = nodes[node];
+    const int64_t size = int64_t(1) << n.level;
+    if (n.population == 0 || x0 >= x + width || y0 >= y + height || x0 + size <= x || y0 + size <= y) {
+        return;
+    }
+    if (n.level == 0) {
+        out[(y0 - y) * width + (x0 - x)] = 1;
+        return;
+    }
+    const int64_t half = size >> 1;
+    read_node(n.nw, out, x, y, width, height, x0, y0);
+    read_node(n.ne, out, x, y, width, height, x0 + half, y0);
+    read_node(n.sw, out, x, y, width, height, x0, y0 + half);
+    read_node(n.se, out, x, y, width, height, x0 + half, y0 + half);
+}
+
+void HashLife::read(uint8_t *out, int64_t x, int64_t y, int width, int height) const {
+    std::fill(out, out + static_cast<int64_t>(width) * height, 0);
+    const int64_t half = int64_t(1) << (nodes[root].level - 1);
+    read_node(root, out, x, y, width, height, -half, -half);
+}
+
+void HashLife::rehash(size_t bucket_count) {
+    buckets.assign(bucket_count, NONE);
+    for (uint32_t i = 0; i < nodes.size(); i++) {
+        Node &n = nodes[i];
+        if (n.level == 0 || n.level == FREE_LEVEL) {
+            continue;
+        }
+        const size_t bucket = hash_children(n.nw, n.ne, n.sw, n.se) & (bucket_count - 1);
+        n.next_in_bucket = buckets[bucket];
+        buckets[bucket] = i;
+    }
+}
+
+void HashLife::collect_garbage() {
+    for (Node &n : nodes) {
+        n.mark = 0;
+    }
+
+    std::vector<uint32_t> stack;
+    stack.push_back(root);
+    stack.insert(stack.end(), empties.begin(), empties.end());
+    stack.insert(stack.end(), level1, level1 + 16);
+    while (!stack.empty()) {
+        const uint32_t i = stack.back();
+        stack.pop_back();
+        Node &n = nodes[i];
+        if (n.mark) {
+            continue;
+        }
+        n.mark = 1;
+        if (n.level > 0) {
+            stack.push_back(n.nw);
+            stack.push_back(n.ne);
+            stack.push_back(n.sw);
+            stack.push_back(n.se);
+        }
+    }
+    nodes[0].mark = 1;
+    nodes[1].mark = 1;
+
+    free_nodes.clear();
+    live_nodes = 0;
+    for (uint32_t i = 0; i < nodes.size(); i++) {
+        Node &n = nodes[i];
+        if (!n.mark) {
+            n.level = FREE_LEVEL;
+            n.result = NONE;
+            free_nodes.push_back(i);
+            continue;
+        }
+        live_nodes++;
+    }
+    // Keep memoized results only when their target survived.
+    for (Node &n : nodes) {
+        if (n.level != FREE_LEVEL && n.result != NONE && !nodes[n.result].mark) {
+            n.result = NONE;
+        }
+    }
+    // Reuse low slots first so the node array stays dense.
+    std::reverse(free_nodes.begin(), free_nodes.end());
+
+    size_t bucket_count = 1024;
+    while (bucket_count < live_nodes) {
+        bucket_count *= 2;
+    }
+    rehash(bucket_count);
+    stats.collections++;
+}
+
+} // namespace automata
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Quadtree-memoized HashLife for Life-like rules without B0.
+//
+// The universe is an unbounded plane. The root node is a 2^L square centered on the origin
+// (cells [-2^(L-1), 2^(L-1)) on both axes, y down) and grows as the pattern spreads. Nodes are
+// hash-consed, so identical subtrees are stored once, and each node memoizes its advanced center.
+// Memory stays bounded by a mark-and-sweep collection between steps.
+
+namespace automata {
+
+class HashLife {
+public:
+    struct Stats {
+        uint64_t join_hits = 0;
+        uint64_t join_misses = 0;
+        uint64_t result_hits = 0;
+        uint64_t result_misses = 0;
+        uint64_t collections = 0;
+    };
+
+    HashLife();
+
+    // Returns false (leaving the rule unchanged) when the rule has B0, which HashLife cannot represent.
+    bool set_rule(uint16_t birth_mask, uint16_t survive_mask);
+
+    void clear();
+    // Replaces the universe with a width x height byte grid whose top-left cell lands on (x, y).
+    void load(const uint8_t *cells, int width, int height, int64_t x, int64_t y);
+    // Writes 0/1 cells of the rectangle at (x, y) into `out` (width * height bytes).
+    void read(uint8_t *out, int64_t x, int64_t y, int width, int height) const;
+
+    // Roots stay at or below MAX_LEVEL so cell coordinates (1 << level) fit in int64_t. A step
+    // needs a root step_log2 + 3 levels deep plus one level to recentre the pattern.
+    static constexpr int MAX_LEVEL = 62;
+    static constexpr int MAX_STEP_LOG2 = MAX_LEVEL - 4;
+
+    // Each step() advances 2^step_log2 generations. Returns false, keeping the old value, for
+    // step_log2 outside [0, MAX_STEP_LOG2].
+    bool set_step_log2(int step_log2);
+    int get_step_log2() const { return step_log2; }
+    // Returns false without advancing when the pattern has spread too far for a root of
+    // MAX_LEVEL.
+    bool step();
+
+    uint64_t get_generation() const { return generation; }
+    uint64_t get_population() const;
+    int get_root_level() const;
+
+    // Collects garbage before a step once more than `max_nodes` nodes are alive (0 = unlimited).
+    void set_max_nodes(uint32_t count) { max_nodes = count; }
+    uint32_t get_max_nodes() const { return max_nodes; }
+    uint32_t get_node_count() const { return live_nodes; }
+    void collect_garbage();
+
+    const Stats &get_stats() const { return stats; }
+    void reset_stats() { stats = Stats(); }
+
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+    static constexpr uint8_t FREE_LEVEL = 0xFF;
+
+    struct Node {
+        uint32_t nw = 0;
+        uint32_t ne = 0;
+        uint32_t sw = 0;
+        uint32_t se = 0;
+        uint32_t result = NONE;
+        uint32_t result_epoch = 0;
+        uint32_t next_in_bucket = NONE;
+        uint8_t level = 0;
+        uint8_t mark = 0;
+        uint64_t population = 0;
+    };
+
+    uint32_t join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+    uint32_t empty(int level);
+    uint32_t center(uint32_t node);
+    uint32_t expand(uint32_t node);
+    uint32_t successor(uint32_t node);
+    uint32_t base_successor(uint32_t node);
+    uint32_t build(const uint8_t *cells, int width, int height, int64_t x, int64_t y, int level, int64_t x0, int64_t y0);
+    void read_node(uint32_t node, uint8_t *out, int64_t x, int64_t y, int width, int height, int64_t x0, int64_t y0) const;
+    bool fits_inner_quarter(uint32_t node) const;
+    void rehash(size_t bucket_count);
+    void invalidate_results();
+
+    static uint64_t hash_children(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> free_nodes;
+    std::vector<uint32_t> buckets;
+    std::vector<uint32_t> empties;
+    uint32_t level1[16];
+    uint8_t base_table[1 << 16];
+    uint32_t live_nodes = 0;
+    uint32_t max_nodes = 4u << 20;
+    uint32_t epoch = 1;
+
+    uint32_t root = NONE;
+    uint16_t birth_mask = 1 << 3;
+    uint16_t survive_mask = (1 << 2) | (1 << 3);
+    int step_log2 = 0;
+    uint64_t generation = 0;
+    Stats stats;
+};
+
+} // namespace automata
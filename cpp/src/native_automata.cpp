@@ -11,17 +11,52 @@
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/color.hpp>
 #include <godot_cpp/variant/typed_array.hpp>
 #include <godot_cpp/variant/vector2i.hpp>
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "automata_common.h"
+#include "native_common.h"
+#include "native_hashlife.h"
+#include "native_sandpile.h"
+#include "native_sparse_world.h"
+#include "native_walkers.h"
+#include "native_wolfram.h"
+#include "sand.h"
+#include "sand_levels.h"
+#include "sand_tiles.h"
+#include "steady_state.h"
+#include "step_budget.h"
+#include "totalistic_active.h"
+#include "totalistic_bits.h"
+#include "totalistic_simd.h"
+#include "totalistic_temporal.h"
+#include "wolfram.h"
+#include "worker_pool.h"
+
+using automata::EDGE_BOUNCE;
+using automata::EDGE_WRAP;
+using automata::clamp_axis;
+using automata::rule_mask;
+using automata::wrap_axis;
 
 namespace {
 
-constexpr int EDGE_WRAP = 0;
-constexpr int EDGE_BOUNCE = 1;
+// Rows per band below which splitting a step across threads costs more than it saves.
+constexpr int MIN_BAND_ROWS = 16;
+// Grid area from which relax_sand relaxes tile worklists on the worker pool rather than
+// sweeping the whole grid per pass.
+constexpr int64_t MIN_TILED_SAND_AREA = 256 * 256;
+// Cells per job when encoding sand levels; smaller chunks cost more in dispatch than they save.
+constexpr int64_t MIN_ENCODE_CHUNK = 64 * 1024;
 
 constexpr int DIR_COUNT = 4;
 const godot::Vector2i DIRS[DIR_COUNT] = {
@@ -31,37 +66,16 @@ const godot::Vector2i DIRS[DIR_COUNT] = {
     godot::Vector2i(-1, 0),
 };
 
-inline int clamp_axis(int value, int max_value) {
-    return std::clamp(value, 0, max_value - 1);
-}
-
-inline int wrap_axis(int value, int max_value) {
-    int m = value % max_value;
-    return m < 0 ? m + max_value : m;
-}
-
-inline int bounce_axis(int value, int max_value) {
-    if (value < 0) {
-        return clamp_axis(-value - 1, max_value);
-    }
-    if (value >= max_value) {
-        return clamp_axis(max_value - (value - max_value) - 1, max_value);
-    }
-    return value;
-}
-
-inline uint8_t sample_cell(const uint8_t *grid, godot::Vector2i size, int x, int y, int edge_mode) {
-    if (x >= 0 && x < size.x && y >= 0 && y < size.y) {
-        return grid[y * size.x + x];
-    }
-
-    switch (edge_mode) {
-        case EDGE_WRAP:
-            return grid[wrap_axis(y, size.y) * size.x + wrap_axis(x, size.x)];
-        case EDGE_BOUNCE:
-            return grid[bounce_axis(y, size.y) * size.x + bounce_axis(x, size.x)];
+const char *steady_kind_name(automata::SteadyKind kind) {
+    switch (kind) {
+        case automata::STEADY_STILL:
+            return "still";
+        case automata::STEADY_PERIODIC:
+            return "periodic";
+        case automata::STEADY_EXTINCT:
+            return "extinct";
         default:
-            return 0;
+            return "active";
     }
 }
 
@@ -74,16 +88,107 @@ namespace godot {
 class NativeAutomata : public RefCounted {
     GDCLASS(NativeAutomata, RefCounted);
 
+    automata::WorkerPool pool;
+
+    // Progress of the step_wolfram_rows call in flight, for a caller polling from another thread.
+    // There is one per instance, so only one sweep per instance may run at a time.
+    automata::WolframProgress wolfram_progress;
+    std::atomic<int64_t> wolfram_rows_requested{ 0 };
+
+    // Activity state for step_totalistic_active: our last output and the output before it, which
+    // becomes the next destination buffer.
+    std::mutex active_mutex;
+    automata::ActiveTileTracker active_tiles;
+    PackedByteArray active_last;
+    PackedByteArray active_prev;
+
+    // Settling state for the byte totalistic steppers: the grid size and rule it was observed
+    // under and our last output, so a call on that exact buffer can skip a step known to be a no-op.
+    std::mutex steady_mutex;
+    automata::SteadyStateDetector steady;
+    PackedByteArray steady_last;
+    Vector2i steady_size;
+    int steady_edge_mode = -1;
+    uint16_t steady_birth = 0;
+    uint16_t steady_survive = 0;
+
+    bool steady_matches(const PackedByteArray &grid, Vector2i size, int edge_mode, uint16_t birth_mask, uint16_t survive_mask) const {
+        return grid.ptr() == steady_last.ptr() && size == steady_size && edge_mode == steady_edge_mode &&
+               birth_mask == steady_birth && survive_mask == steady_survive;
+    }
+
+    void write_steady(Dictionary &result) const {
+        const automata::SteadyStatus status = steady.get_status();
+        result["steady_state"] = String(steady_kind_name(status.kind));
+        result["period"] = status.period;
+    }
+
+    // Fills `result` and returns true when `grid` is our last output and stepping it by
+    // `generations` is known to leave it unchanged.
+    bool skip_settled(const PackedByteArray &grid, Vector2i size, int edge_mode, uint16_t birth_mask, uint16_t survive_mask, int generations, Dictionary &result) {
+        std::lock_guard<std::mutex> lock(steady_mutex);
+        if (!steady_matches(grid, size, edge_mode, birth_mask, survive_mask) || !steady.can_skip(generations)) {
+            return false;
+        }
+        steady.skip(generations);
+        result["grid"] = grid;
+        result["changed"] = false;
+        write_steady(result);
+        return true;
+    }
+
+    // Hashes the new generation into the settling history. Edits made since our last output
+    // restart the history, since a repeat across an edit says nothing about the rule's orbit.
+    // `dirty` flags the tiles that differ from `grid` when the stepper tracked them (see
+    // SteadyStateDetector::observe); only those are rehashed.
+    void record_steady(const PackedByteArray &grid, const PackedByteArray &next_state, Vector2i size, int edge_mode, uint16_t birth_mask, uint16_t survive_mask, bool changed, int generations, Dictionary &result, const uint8_t *dirty = nullptr) {
+        std::lock_guard<std::mutex> lock(steady_mutex);
+        if (!steady_matches(grid, size, edge_mode, birth_mask, survive_mask)) {
+            steady.reset();
+            steady_size = size;
+            steady_edge_mode = edge_mode;
+            steady_birth = birth_mask;
+            steady_survive = survive_mask;
+        }
+        steady.observe(next_state.ptr(), size.x, size.y, dirty, changed, generations, birth_mask);
+        steady_last = next_state;
+        write_steady(result);
+    }
+
 protected:
     static void _bind_methods() {
         ClassDB::bind_method(D_METHOD("step_totalistic", "grid", "size", "birth", "survive", "edge_mode"), &NativeAutomata::step_totalistic);
-        ClassDB::bind_method(D_METHOD("step_sand", "grid", "size", "edge_mode"), &NativeAutomata::step_sand);
+        ClassDB::bind_method(D_METHOD("step_totalistic_n", "grid", "size", "birth", "survive", "edge_mode", "generations"), &NativeAutomata::step_totalistic_n);
+        ClassDB::bind_method(D_METHOD("run_totalistic_for", "grid", "size", "birth", "survive", "edge_mode", "budget_usec", "max_generations"), &NativeAutomata::run_totalistic_for);
+        ClassDB::bind_method(D_METHOD("step_totalistic_active", "grid", "size", "birth", "survive", "edge_mode"), &NativeAutomata::step_totalistic_active);
+        ClassDB::bind_method(D_METHOD("reset_totalistic_activity"), &NativeAutomata::reset_totalistic_activity);
+        ClassDB::bind_method(D_METHOD("get_steady_state"), &NativeAutomata::get_steady_state);
+        ClassDB::bind_method(D_METHOD("reset_steady_state"), &NativeAutomata::reset_steady_state);
+        ClassDB::bind_method(D_METHOD("pack_totalistic_grid", "grid", "size"), &NativeAutomata::pack_totalistic_grid);
+        ClassDB::bind_method(D_METHOD("unpack_totalistic_grid", "bits", "size"), &NativeAutomata::unpack_totalistic_grid);
+        ClassDB::bind_method(D_METHOD("step_totalistic_packed", "bits", "size", "birth", "survive", "edge_mode"), &NativeAutomata::step_totalistic_packed);
+        ClassDB::bind_method(D_METHOD("get_simd_level"), &NativeAutomata::get_simd_level);
+        ClassDB::bind_method(D_METHOD("set_simd_level_limit", "level"), &NativeAutomata::set_simd_level_limit);
+        ClassDB::bind_method(D_METHOD("set_thread_count", "count"), &NativeAutomata::set_thread_count);
+        ClassDB::bind_method(D_METHOD("get_thread_count"), &NativeAutomata::get_thread_count);
+        ClassDB::bind_method(D_METHOD("step_sand", "grid", "size", "edge_mode", "threshold", "neighborhood"), &NativeAutomata::step_sand, DEFVAL(4), DEFVAL(automata::SAND_VON_NEUMANN));
+        ClassDB::bind_method(D_METHOD("relax_sand", "grid", "size", "edge_mode", "max_topples", "threshold", "neighborhood"), &NativeAutomata::relax_sand, DEFVAL(0), DEFVAL(4), DEFVAL(automata::SAND_VON_NEUMANN));
+        ClassDB::bind_method(D_METHOD("encode_sand_levels", "grid", "size", "palette_size"), &NativeAutomata::encode_sand_levels);
+        ClassDB::bind_method(D_METHOD("drop_and_stabilize", "grid", "size", "position", "amount", "edge_mode", "threshold", "neighborhood"), &NativeAutomata::drop_and_stabilize, DEFVAL(automata::EDGE_FALLOFF), DEFVAL(4), DEFVAL(automata::SAND_VON_NEUMANN));
         ClassDB::bind_method(D_METHOD("step_wolfram", "grid", "size", "rule", "row", "edge_mode", "allow_wrap"), &NativeAutomata::step_wolfram);
+        ClassDB::bind_method(D_METHOD("step_wolfram_rows", "grid", "size", "rule", "start_row", "count", "edge_mode", "allow_wrap"), &NativeAutomata::step_wolfram_rows);
+        ClassDB::bind_method(D_METHOD("begin_wolfram_rows", "count"), &NativeAutomata::begin_wolfram_rows);
+        ClassDB::bind_method(D_METHOD("get_wolfram_rows_progress"), &NativeAutomata::get_wolfram_rows_progress);
+        ClassDB::bind_method(D_METHOD("build_wolfram_atlas", "seed", "rows", "edge_mode"), &NativeAutomata::build_wolfram_atlas);
+        ClassDB::bind_method(D_METHOD("cancel_wolfram_rows"), &NativeAutomata::cancel_wolfram_rows);
         ClassDB::bind_method(D_METHOD("step_ants", "grid", "size", "edge_mode", "ants", "directions", "colors"), &NativeAutomata::step_ants);
         ClassDB::bind_method(D_METHOD("step_turmites", "grid", "size", "edge_mode", "ants", "directions", "colors", "rule"), &NativeAutomata::step_turmites);
     }
 
 public:
+    // The byte totalistic steppers also report "steady_state" ("active", "still", "periodic" or
+    // "extinct") and "period" (see steady_state.h). Once the grid is still or extinct, passing the
+    // returned grid back unedited costs no step at all.
     Dictionary step_totalistic(const PackedByteArray &grid, Vector2i size, const TypedArray<int> &birth, const TypedArray<int> &survive, int edge_mode) {
         Dictionary result;
         if (size.x <= 0 || size.y <= 0 || grid.size() != size.x * size.y) {
@@ -92,141 +197,116 @@ public:
             return result;
         }
 
+        const uint16_t birth_mask = rule_mask(birth);
+        const uint16_t survive_mask = rule_mask(survive);
+        if (skip_settled(grid, size, edge_mode, birth_mask, survive_mask, 1, result)) {
+            return result;
+        }
+
         PackedByteArray next_state;
         next_state.resize(grid.size());
 
         const uint8_t *src = grid.ptr();
         uint8_t *dst = next_state.ptrw();
+        const bool changed = pool.run_row_bands(size.y, MIN_BAND_ROWS, [&](int begin, int end) {
+            return automata::step_bytes_rows(src, dst, size.x, size.y, begin, end, edge_mode, birth_mask, survive_mask);
+        });
 
-        bool birth_set[9] = {};
-        bool survive_set[9] = {};
-        for (int i = 0; i < birth.size(); i++) {
-            int val = birth[i];
-            if (val >= 0 && val < 9) {
-                birth_set[val] = true;
-            }
+        result["grid"] = next_state;
+        result["changed"] = changed;
+        record_steady(grid, next_state, size, edge_mode, birth_mask, survive_mask, changed, 1, result);
+        return result;
+    }
+
+    // Advances `generations` generations in one call using cache-blocked row tiles. Output matches
+    // calling step_totalistic that many times; "changed" compares the result with the input grid.
+    Dictionary step_totalistic_n(const PackedByteArray &grid, Vector2i size, const TypedArray<int> &birth, const TypedArray<int> &survive, int edge_mode, int generations) {
+        Dictionary result;
+        if (size.x <= 0 || size.y <= 0 || grid.size() != size.x * size.y || generations <= 0) {
+            result["grid"] = grid;
+            result["changed"] = false;
+            return result;
         }
-        for (int i = 0; i < survive.size(); i++) {
-            int val = survive[i];
-            if (val >= 0 && val < 9) {
-                survive_set[val] = true;
-            }
+
+        const uint16_t birth_mask = rule_mask(birth);
+        const uint16_t survive_mask = rule_mask(survive);
+        if (skip_settled(grid, size, edge_mode, birth_mask, survive_mask, generations, result)) {
+            return result;
         }
 
-        bool changed = true;
-        switch (edge_mode) {
-            case 0: { // EDGE_WRAP
-                for (int y = 0; y < size.y; y++) {
-                    const int y_up = wrap_axis(y - 1, size.y);
-                    const int y_down = wrap_axis(y + 1, size.y);
-                    const int row = y * size.x;
-                    const int row_up = y_up * size.x;
-                    const int row_down = y_down * size.x;
-                    for (int x = 0; x < size.x; x++) {
-                        const int x_left = wrap_axis(x - 1, size.x);
-                        const int x_right = wrap_axis(x + 1, size.x);
-
-                        int neighbors = src[row_up + x_left] + src[row_up + x] + src[row_up + x_right] +
-                                        src[row + x_left] + src[row + x_right] +
-                                        src[row_down + x_left] + src[row_down + x] + src[row_down + x_right];
-
-                        int new_val = 0;
-                        if (src[row + x] == 1) {
-                            if (survive_set[neighbors]) {
-                                new_val = 1;
-                            }
-                        } else if (birth_set[neighbors]) {
-                            new_val = 1;
-                        }
-
-                        dst[row + x] = static_cast<uint8_t>(new_val);
-                        if (!changed && new_val != src[row + x]) {
-                            changed = true;
-                        }
-                    }
-                }
-                break;
-            }
-            case 1: { // EDGE_BOUNCE
-                for (int y = 0; y < size.y; y++) {
-                    const int y_up = clamp_axis(y - 1, size.y);
-                    const int y_down = clamp_axis(y + 1, size.y);
-                    const int row = y * size.x;
-                    const int row_up = y_up * size.x;
-                    const int row_down = y_down * size.x;
-                    for (int x = 0; x < size.x; x++) {
-                        const int x_left = clamp_axis(x - 1, size.x);
-                        const int x_right = clamp_axis(x + 1, size.x);
-
-                        int neighbors = src[row_up + x_left] + src[row_up + x] + src[row_up + x_right] +
-                                        src[row + x_left] + src[row + x_right] +
-                                        src[row_down + x_left] + src[row_down + x] + src[row_down + x_right];
-
-                        int new_val = 0;
-                        if (src[row + x] == 1) {
-                            if (survive_set[neighbors]) {
-                                new_val = 1;
-                            }
-                        } else if (birth_set[neighbors]) {
-                            new_val = 1;
-                        }
-
-                        dst[row + x] = static_cast<uint8_t>(new_val);
-                        if (!changed && new_val != src[row + x]) {
-                            changed = true;
-                        }
-                    }
-                }
-                break;
+        PackedByteArray next_state;
+        next_state.resize(grid.size());
+        Vector<uint8_t> scratch;
+        if (generations > 1) {
+            scratch.resize(grid.size());
+        }
+        const bool changed = automata::step_bytes_generations(grid.ptr(), next_state.ptrw(), scratch.ptrw(), size.x, size.y, edge_mode,
+                birth_mask, survive_mask, generations, pool);
+
+        result["grid"] = next_state;
+        result["changed"] = changed;
+        record_steady(grid, next_state, size, edge_mode, birth_mask, survive_mask, changed, generations, result);
+        return result;
+    }
+
+    // Advances as many generations as fit in `budget_usec` microseconds, at most `max_generations`
+    // (at least one runs). The first generation measures the step time; later ones run in batches
+    // through step_bytes_generations, each no larger than everything run so far, so a misjudged
+    // batch overshoots by at most the time already spent. Extra key: "generations".
+    Dictionary run_totalistic_for(const PackedByteArray &grid, Vector2i size, const TypedArray<int> &birth, const TypedArray<int> &survive, int edge_mode, int64_t budget_usec, int64_t max_generations) {
+        Dictionary result;
+        if (size.x <= 0 || size.y <= 0 || grid.size() != size.x * size.y || max_generations <= 0) {
+            result["grid"] = grid;
+            result["changed"] = false;
+            result["generations"] = 0;
+            return result;
+        }
+
+        const uint16_t birth_mask = rule_mask(birth);
+        const uint16_t survive_mask = rule_mask(survive);
+        const int generations_cap = static_cast<int>(std::min<int64_t>(max_generations, INT32_MAX));
+        if (skip_settled(grid, size, edge_mode, birth_mask, survive_mask, generations_cap, result)) {
+            result["generations"] = generations_cap;
+            return result;
+        }
+
+        // Batches alternate between the two buffers; the last one written is the result.
+        PackedByteArray next_state;
+        next_state.resize(grid.size());
+        Vector<uint8_t> other;
+        Vector<uint8_t> scratch;
+        const uint8_t *src = grid.ptr();
+        uint8_t *dst = next_state.ptrw();
+        automata::StepBudget budget(budget_usec, generations_cap);
+        for (int64_t batch = budget.take(); batch > 0; batch = budget.take(budget.get_steps())) {
+            if (batch > 1 && scratch.size() != grid.size()) {
+                scratch.resize(grid.size());
             }
-            default: { // EDGE_FALLOFF or unknown
-                for (int y = 0; y < size.y; y++) {
-                    const int row = y * size.x;
-                    for (int x = 0; x < size.x; x++) {
-                        int neighbors = 0;
-                        for (int dy = -1; dy <= 1; dy++) {
-                            const int ny = y + dy;
-                            if (ny < 0 || ny >= size.y) {
-                                continue;
-                            }
-                            const int nrow = ny * size.x;
-                            for (int dx = -1; dx <= 1; dx++) {
-                                const int nx = x + dx;
-                                if (dx == 0 && dy == 0) {
-                                    continue;
-                                }
-                                if (nx < 0 || nx >= size.x) {
-                                    continue;
-                                }
-                                neighbors += src[nrow + nx];
-                            }
-                        }
-
-                        int new_val = 0;
-                        if (src[row + x] == 1) {
-                            if (survive_set[neighbors]) {
-                                new_val = 1;
-                            }
-                        } else if (birth_set[neighbors]) {
-                            new_val = 1;
-                        }
-
-                        dst[row + x] = static_cast<uint8_t>(new_val);
-                        if (!changed && new_val != src[row + x]) {
-                            changed = true;
-                        }
-                    }
-                }
-                break;
+            automata::step_bytes_generations(src, dst, scratch.ptrw(), size.x, size.y, edge_mode, birth_mask, survive_mask, static_cast<int>(batch), pool);
+            if (src == grid.ptr()) {
+                other.resize(grid.size());
             }
+            src = dst;
+            dst = dst == next_state.ptrw() ? other.ptrw() : next_state.ptrw();
+        }
+        if (src != next_state.ptr()) {
+            std::memcpy(next_state.ptrw(), src, static_cast<size_t>(grid.size()));
         }
 
+        const int generations = static_cast<int>(budget.get_steps());
+        const bool changed = std::memcmp(next_state.ptr(), grid.ptr(), static_cast<size_t>(grid.size())) != 0;
         result["grid"] = next_state;
         result["changed"] = changed;
+        result["generations"] = generations;
+        record_steady(grid, next_state, size, edge_mode, birth_mask, survive_mask, changed, generations, result);
         return result;
     }
 
-    Dictionary step_sand(const PackedInt32Array &grid, Vector2i size, int edge_mode) {
+    // Like step_totalistic, but only recomputes 64x64 tiles that changed in the previous call (or
+    // border one that did). Edits made to the returned grid between calls are found by comparing
+    // against the retained copy. Extra keys: "dirty_tiles" (one byte per tile, row-major, 1 when
+    // the tile changed), "tile_size", "tile_counts" (Vector2i) and "active_tiles".
+    Dictionary step_totalistic_active(const PackedByteArray &grid, Vector2i size, const TypedArray<int> &birth, const TypedArray<int> &survive, int edge_mode) {
         Dictionary result;
         if (size.x <= 0 || size.y <= 0 || grid.size() != size.x * size.y) {
             result["grid"] = grid;
@@ -234,60 +314,266 @@ public:
             return result;
         }
 
-        PackedInt32Array next = grid;
-        const int32_t *src = grid.ptr();
-        int32_t *dst = next.ptrw();
-        Vector<int> updates;
-
-        for (int y = 0; y < size.y; y++) {
-            for (int x = 0; x < size.x; x++) {
-                int idx = y * size.x + x;
-                if (src[idx] >= 4) {
-                    updates.push_back(idx);
-                }
-            }
+        const uint16_t birth_mask = rule_mask(birth);
+        const uint16_t survive_mask = rule_mask(survive);
+        if (skip_settled(grid, size, edge_mode, birth_mask, survive_mask, 1, result)) {
+            const int tiles_x = (size.x + automata::ActiveTileTracker::TILE - 1) / automata::ActiveTileTracker::TILE;
+            const int tiles_y = (size.y + automata::ActiveTileTracker::TILE - 1) / automata::ActiveTileTracker::TILE;
+            PackedByteArray dirty_tiles;
+            dirty_tiles.resize(static_cast<int64_t>(tiles_x) * tiles_y);
+            dirty_tiles.fill(0);
+            result["dirty_tiles"] = dirty_tiles;
+            result["tile_size"] = automata::ActiveTileTracker::TILE;
+            result["tile_counts"] = Vector2i(tiles_x, tiles_y);
+            result["active_tiles"] = 0;
+            return result;
         }
 
-        if (updates.is_empty()) {
+        std::lock_guard<std::mutex> lock(active_mutex);
+        if (!active_tiles.matches(size.x, size.y, edge_mode, birth_mask, survive_mask) || active_last.size() != grid.size() || active_prev.size() != grid.size()) {
+            active_tiles.reset(size.x, size.y, edge_mode, birth_mask, survive_mask);
+            active_last = PackedByteArray();
+            active_prev = PackedByteArray();
+            active_prev.resize(grid.size());
+        } else if (grid.ptr() != active_last.ptr()) {
+            // The caller passed a different buffer (edited, or not our last output).
+            active_tiles.mark_diff(grid.ptr(), active_last.ptr());
+        }
+
+        // Drop our reference first so writing the recycled buffer does not trigger a copy.
+        PackedByteArray next_state = active_prev;
+        active_prev = PackedByteArray();
+        const bool changed = active_tiles.step(grid.ptr(), next_state.ptrw(), pool);
+        active_prev = grid;
+        active_last = next_state;
+
+        const std::vector<uint8_t> &tile_changes = active_tiles.get_changed();
+        PackedByteArray dirty_tiles;
+        dirty_tiles.resize(static_cast<int64_t>(tile_changes.size()));
+        std::copy(tile_changes.begin(), tile_changes.end(), dirty_tiles.ptrw());
+
+        result["grid"] = next_state;
+        result["changed"] = changed;
+        result["dirty_tiles"] = dirty_tiles;
+        result["tile_size"] = automata::ActiveTileTracker::TILE;
+        result["tile_counts"] = Vector2i(active_tiles.get_tiles_x(), active_tiles.get_tiles_y());
+        result["active_tiles"] = active_tiles.get_active_count();
+        record_steady(grid, next_state, size, edge_mode, birth_mask, survive_mask, changed, 1, result, tile_changes.data());
+        return result;
+    }
+
+    // Settling status of the last byte totalistic step: "state", "period" and "generation"
+    // (generations observed since the history last restarted).
+    Dictionary get_steady_state() {
+        std::lock_guard<std::mutex> lock(steady_mutex);
+        Dictionary result;
+        const automata::SteadyStatus status = steady.get_status();
+        result["state"] = String(steady_kind_name(status.kind));
+        result["period"] = status.period;
+        result["generation"] = steady.get_generation();
+        return result;
+    }
+
+    // Forgets the settling history and the retained output; the next step always runs.
+    void reset_steady_state() {
+        std::lock_guard<std::mutex> lock(steady_mutex);
+        steady.reset();
+        steady_last = PackedByteArray();
+        steady_edge_mode = -1;
+    }
+
+    // Releases the buffers kept by step_totalistic_active; the next call recomputes every tile.
+    void reset_totalistic_activity() {
+        std::lock_guard<std::mutex> lock(active_mutex);
+        active_tiles.reset(0, 0, -1, 0, 0);
+        active_last = PackedByteArray();
+        active_prev = PackedByteArray();
+    }
+
+    // Bit-packed variant of the totalistic stepper: rows of 64-cell words (see totalistic_bits.h).
+    // Callers keep the packed buffer between steps and only unpack when they need bytes again.
+    PackedInt64Array pack_totalistic_grid(const PackedByteArray &grid, Vector2i size) {
+        PackedInt64Array bits;
+        if (size.x <= 0 || size.y <= 0 || grid.size() != size.x * size.y) {
+            return bits;
+        }
+        bits.resize(static_cast<int64_t>(automata::words_per_row(size.x)) * size.y);
+        automata::pack_rows(grid.ptr(), size.x, size.y, reinterpret_cast<uint64_t *>(bits.ptrw()));
+        return bits;
+    }
+
+    PackedByteArray unpack_totalistic_grid(const PackedInt64Array &bits, Vector2i size) {
+        PackedByteArray grid;
+        if (size.x <= 0 || size.y <= 0 || bits.size() != static_cast<int64_t>(automata::words_per_row(size.x)) * size.y) {
+            return grid;
+        }
+        grid.resize(size.x * size.y);
+        automata::unpack_rows(reinterpret_cast<const uint64_t *>(bits.ptr()), size.x, size.y, grid.ptrw());
+        return grid;
+    }
+
+    Dictionary step_totalistic_packed(const PackedInt64Array &bits, Vector2i size, const TypedArray<int> &birth, const TypedArray<int> &survive, int edge_mode) {
+        Dictionary result;
+        if (size.x <= 0 || size.y <= 0 || bits.size() != static_cast<int64_t>(automata::words_per_row(size.x)) * size.y) {
+            result["grid"] = bits;
+            result["changed"] = false;
+            return result;
+        }
+
+        PackedInt64Array next_state;
+        next_state.resize(bits.size());
+        const uint64_t *src = reinterpret_cast<const uint64_t *>(bits.ptr());
+        uint64_t *dst = reinterpret_cast<uint64_t *>(next_state.ptrw());
+        const uint16_t birth_mask = rule_mask(birth);
+        const uint16_t survive_mask = rule_mask(survive);
+        const bool changed = pool.run_row_bands(size.y, MIN_BAND_ROWS, [&](int begin, int end) {
+            return automata::step_bits_rows(src, dst, size.x, size.y, begin, end, edge_mode, birth_mask, survive_mask);
+        });
+
+        result["grid"] = next_state;
+        result["changed"] = changed;
+        return result;
+    }
+
+    // Name of the vector ISA the byte kernels dispatch to ("scalar", "sse2", "avx2", "avx512").
+    String get_simd_level() const {
+        return String(automata::simd_level_name(automata::active_simd_level()));
+    }
+
+    // Caps kernel dispatch at 0 = scalar, 1 = SSE2, 2 = AVX2, 3 = AVX-512 to compare ISAs.
+    // The limit is process-wide; outputs are identical at every level.
+    void set_simd_level_limit(int level) {
+        automata::set_simd_level_limit(level);
+    }
+
+    // Threads used by the grid-wide steppers (the calling thread included). 0 = one per CPU core.
+    void set_thread_count(int count) {
+        pool.set_thread_count(std::max(0, count));
+    }
+
+    int get_thread_count() const {
+        return pool.get_thread_count();
+    }
+
+    // `neighborhood` is 0 for the 4 von Neumann neighbors and 1 for the 8 Moore neighbors; a
+    // toppling cell loses `threshold` grains, which must be at least the neighbor count (the grid
+    // is returned unchanged otherwise). The same holds for relax_sand and drop_and_stabilize.
+    Dictionary step_sand(const PackedInt32Array &grid, Vector2i size, int edge_mode, int32_t threshold, int neighborhood) {
+        const automata::SandRule rule{ threshold, neighborhood };
+        Dictionary result;
+        if (size.x <= 0 || size.y <= 0 || grid.size() != size.x * size.y || !automata::sand_rule_valid(rule)) {
             result["grid"] = grid;
             result["changed"] = false;
             return result;
         }
 
-        for (int i = 0; i < updates.size(); i++) {
-            const int idx = updates[i];
-            const int y = idx / size.x;
-            const int x = idx - (y * size.x);
-            dst[idx] -= 4;
-
-            for (const Vector2i &dir : {Vector2i(0, -1), Vector2i(1, 0), Vector2i(0, 1), Vector2i(-1, 0)}) {
-                int nx = x + dir.x;
-                int ny = y + dir.y;
-                switch (edge_mode) {
-                    case 0: // EDGE_WRAP
-                        nx = (nx % size.x + size.x) % size.x;
-                        ny = (ny % size.y + size.y) % size.y;
-                        break;
-                    case 1: // EDGE_BOUNCE
-                        nx = clamp_axis(nx, size.x);
-                        ny = clamp_axis(ny, size.y);
-                        break;
-                    case 2: // EDGE_FALLOFF
-                        if (nx < 0 || nx >= size.x || ny < 0 || ny >= size.y) {
-                            continue;
-                        }
-                        break;
-                    default:
-                        break;
-                }
-
-                const int nidx = ny * size.x + nx;
-                dst[nidx] += 1;
-            }
+        PackedInt32Array next;
+        next.resize(grid.size());
+        if (!automata::step_sand_grid(grid.ptr(), next.ptrw(), size.x, size.y, edge_mode, rule)) {
+            result["grid"] = grid;
+            result["changed"] = false;
+            return result;
+        }
+
+        result["grid"] = next;
+        result["changed"] = true;
+        return result;
+    }
+
+    // Topples the pile toward stability in one call, grains / threshold at a time per cell,
+    // stopping once the pile is stable or `max_topples` single-cell topplings were done (0 = no
+    // limit; checked after each pass). Wrap and bounce piles that keep every grain may never
+    // settle from neighbors / 2 grains per cell on, so "no limit" stops after
+    // SAND_UNGUARANTEED_MAX_TOPPLES there (see sand.h). Large grids relax tile by tile on the worker pool instead (see
+    // sand_tiles.h), with the same stable result. Extra keys: "topples", "passes" and "stable".
+    Dictionary relax_sand(const PackedInt32Array &grid, Vector2i size, int edge_mode, int64_t max_topples, int32_t threshold, int neighborhood) {
+        const automata::SandRule rule{ threshold, neighborhood };
+        Dictionary result;
+        if (size.x <= 0 || size.y <= 0 || grid.size() != size.x * size.y || !automata::sand_rule_valid(rule)) {
+            result["grid"] = grid;
+            result["changed"] = false;
+            result["topples"] = 0;
+            result["passes"] = 0;
+            result["stable"] = true;
+            return result;
+        }
+
+        PackedInt32Array next = grid;
+        const bool tiled = static_cast<int64_t>(size.x) * size.y >= MIN_TILED_SAND_AREA;
+        const automata::SandRelaxResult relax = tiled
+                ? automata::relax_sand_tiles(next.ptrw(), size.x, size.y, edge_mode, max_topples, pool, rule)
+                : automata::relax_sand_grid(next.ptrw(), size.x, size.y, edge_mode, max_topples, rule);
+
+        result["grid"] = relax.topples > 0 ? next : grid;
+        result["changed"] = relax.topples > 0;
+        result["topples"] = relax.topples;
+        result["passes"] = relax.passes;
+        result["stable"] = relax.stable;
+        return result;
+    }
+
+    // Drops `amount` grains at `position` and returns the stable pile, identical to dropping them
+    // one at a time but built in doubling stages (see drop_sand_stabilized). Wrap and bounce
+    // grids that keep every grain refuse drops that would leave neighbors / 2 or more grains per
+    // cell and return "stable" false. Extra keys: "topples", "passes" and "stable".
+    Dictionary drop_and_stabilize(const PackedInt32Array &grid, Vector2i size, Vector2i position, int64_t amount, int edge_mode, int32_t threshold, int neighborhood) {
+        const automata::SandRule rule{ threshold, neighborhood };
+        Dictionary result;
+        result["grid"] = grid;
+        result["changed"] = false;
+        result["topples"] = 0;
+        result["passes"] = 0;
+        result["stable"] = false;
+        if (size.x <= 0 || size.y <= 0 || grid.size() != size.x * size.y || !automata::sand_rule_valid(rule)) {
+            return result;
+        }
+        if (position.x < 0 || position.x >= size.x || position.y < 0 || position.y >= size.y || amount <= 0) {
+            return result;
         }
 
+        PackedInt32Array next = grid;
+        const automata::SandRelaxResult drop = automata::drop_sand_stabilized(next.ptrw(), size.x, size.y, edge_mode, position.x, position.y, amount, pool, rule);
+        if (!drop.stable) {
+            return result;
+        }
         result["grid"] = next;
         result["changed"] = true;
+        result["topples"] = drop.topples;
+        result["passes"] = drop.passes;
+        result["stable"] = true;
+        return result;
+    }
+
+    // R8 palette indices for the sand texture (see sand_levels.h), split into chunks across the
+    // worker pool. Cells past the end of a short `grid` encode as empty, as in
+    // build_sand_image_from_data. Keys: "levels" (PackedByteArray) and "has_content".
+    Dictionary encode_sand_levels(const PackedInt32Array &grid, Vector2i size, int palette_size) {
+        Dictionary result;
+        PackedByteArray levels;
+        if (size.x <= 0 || size.y <= 0) {
+            result["levels"] = levels;
+            result["has_content"] = false;
+            return result;
+        }
+
+        const int64_t count = static_cast<int64_t>(size.x) * size.y;
+        const int64_t encoded = std::min<int64_t>(count, grid.size());
+        levels.resize(count);
+        uint8_t *dst = levels.ptrw();
+        const int32_t *src = grid.ptr();
+        const int64_t chunks = std::max<int64_t>(1, std::min<int64_t>(encoded / MIN_ENCODE_CHUNK, pool.get_thread_count() * 4));
+        std::vector<uint8_t> content(chunks, 0);
+        pool.run(static_cast<uint32_t>(chunks), [&](uint32_t i) {
+            const int64_t begin = encoded * i / chunks;
+            const int64_t end = encoded * (i + 1) / chunks;
+            content[i] = automata::encode_sand_levels(src + begin, dst + begin, static_cast<size_t>(end - begin), palette_size) ? 1 : 0;
+        });
+        if (encoded < count) {
+            memset(dst + encoded, 0, static_cast<size_t>(count - encoded));
+        }
+
+        result["levels"] = levels;
+        result["has_content"] = std::find(content.begin(), content.end(), 1) != content.end();
         return result;
     }
 
@@ -323,15 +609,7 @@ public:
         }
 
         bool changed = true; // always advance the sweep row
-        for (int x = 0; x < size.x; x++) {
-            const uint8_t left = sample_cell(src, size, x - 1, source_row, edge_mode);
-            const uint8_t center = sample_cell(src, size, x, source_row, edge_mode);
-            const uint8_t right = sample_cell(src, size, x + 1, source_row, edge_mode);
-            const int key = (left << 2) | (center << 1) | right;
-            const uint8_t state = (rule >> key) & 1;
-            const int idx = current_row * size.x + x;
-            dst[idx] = state;
-        }
+        automata::step_wolfram_row(src + static_cast<int64_t>(source_row) * size.x, dst + static_cast<int64_t>(current_row) * size.x, size.x, rule, edge_mode);
 
         const int32_t next_row = allow_wrap ? (current_row + 1) % size.y : current_row + 1;
 
@@ -341,6 +619,83 @@ public:
         return result;
     }
 
+    // Sweeps up to `count` rows from `start_row` in one call, with step_wolfram's row rules (see
+    // automata::step_wolfram_rows). The grid is copied once and the rows stream through a two-row
+    // packed working set. Another thread can poll get_wolfram_rows_progress() and stop the sweep with
+    // cancel_wolfram_rows(). A sweep consumes the cancel request, so one issued before the sweep
+    // starts still stops it; call begin_wolfram_rows() before dispatching to clear an older one.
+    // One sweep per instance at a time. Extra keys: "rows" (rows written) and "cancelled".
+    Dictionary step_wolfram_rows(const PackedByteArray &grid, Vector2i size, int32_t rule, int32_t start_row, int64_t count, int edge_mode, bool allow_wrap) {
+        Dictionary result;
+        wolfram_progress.rows.store(0, std::memory_order_relaxed);
+        wolfram_rows_requested.store(std::max<int64_t>(count, 0), std::memory_order_relaxed);
+        if (size.x <= 0 || size.y <= 0 || grid.size() != size.x * size.y || count <= 0) {
+            wolfram_progress.cancel.store(false, std::memory_order_relaxed);
+            result["grid"] = grid;
+            result["row"] = start_row;
+            result["rows"] = 0;
+            result["changed"] = false;
+            result["cancelled"] = false;
+            return result;
+        }
+
+        int32_t current_row = allow_wrap ? wrap_axis(start_row, size.y) : start_row;
+        PackedByteArray next_state = grid;
+        int64_t written = 0;
+        if (current_row >= 0 && current_row < size.y) {
+            written = automata::step_wolfram_rows(next_state.ptrw(), size.x, size.y, rule, current_row, count, edge_mode, allow_wrap, &wolfram_progress);
+        }
+        const int64_t next_row = allow_wrap ? (current_row + written) % size.y : current_row + written;
+
+        result["grid"] = written > 0 ? next_state : grid;
+        result["row"] = next_row;
+        result["rows"] = written;
+        result["changed"] = written > 0;
+        const bool cancel_requested = wolfram_progress.cancel.exchange(false, std::memory_order_relaxed);
+        result["cancelled"] = written < count && cancel_requested;
+        return result;
+    }
+
+    // Resets the progress and any pending cancel for a sweep of `count` rows. Call it on the
+    // dispatching thread before handing step_wolfram_rows to a worker, so polls see the new count
+    // and a cancel_wolfram_rows() issued before the worker starts is kept.
+    void begin_wolfram_rows(int64_t count) {
+        wolfram_progress.rows.store(0, std::memory_order_relaxed);
+        wolfram_progress.cancel.store(false, std::memory_order_relaxed);
+        wolfram_rows_requested.store(std::max<int64_t>(count, 0), std::memory_order_relaxed);
+    }
+
+    // Keys: "rows" (written so far by the step_wolfram_rows call in flight, or by the last one) and "count".
+    Dictionary get_wolfram_rows_progress() const {
+        Dictionary result;
+        result["rows"] = wolfram_progress.rows.load(std::memory_order_relaxed);
+        result["count"] = wolfram_rows_requested.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    void cancel_wolfram_rows() {
+        wolfram_progress.cancel.store(true, std::memory_order_relaxed);
+    }
+
+    // Renders every elementary rule from the seed row for `rows` rows (the seed included) in one
+    // pass. Keys: "image" (0/1 bytes, rule r in tile (r % 16, r / 16)), "size" (image size),
+    // "tile_size" (seed width x rows) and "columns".
+    Dictionary build_wolfram_atlas(const PackedByteArray &seed, int rows, int edge_mode) {
+        Dictionary result;
+        const int width = static_cast<int>(seed.size());
+        const int columns = automata::WOLFRAM_ATLAS_COLUMNS;
+        PackedByteArray image;
+        if (width > 0 && rows > 0) {
+            image.resize(static_cast<int64_t>(width) * rows * columns * columns);
+            automata::build_wolfram_atlas(seed.ptr(), width, rows, edge_mode, image.ptrw());
+        }
+        result["image"] = image;
+        result["size"] = width > 0 && rows > 0 ? Vector2i(width * columns, rows * columns) : Vector2i();
+        result["tile_size"] = Vector2i(std::max(width, 0), std::max(rows, 0));
+        result["columns"] = columns;
+        return result;
+    }
+
     Dictionary step_ants(const PackedByteArray &grid, Vector2i size, int edge_mode, const TypedArray<Vector2i> &ants, const TypedArray<int> &directions, const TypedArray<Color> &colors) {
         Dictionary result;
         const int count = static_cast<int>(std::min<int64_t>(ants.size(), directions.size()));
@@ -533,6 +888,11 @@ GDExtensionBool GDE_EXPORT native_automata_library_init(GDExtensionInterfaceGetP
     init_obj.register_initializer([](godot::ModuleInitializationLevel level) {
         if (level == godot::MODULE_INITIALIZATION_LEVEL_SCENE) {
             godot::ClassDB::register_class<godot::NativeAutomata>();
+            godot::ClassDB::register_class<godot::NativeHashLife>();
+            godot::ClassDB::register_class<godot::NativeSparseWorld>();
+            godot::ClassDB::register_class<godot::NativeSandpile>();
+            godot::ClassDB::register_class<godot::NativeWolfram>();
+            godot::ClassDB::register_class<godot::NativeWalkers>();
         }
     });
 
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <godot_cpp/variant/typed_array.hpp>
+
+#include <cstdint>
+
+namespace automata {
+
+// Folds a list of neighbor counts (e.g. [2, 3]) into a mask with bit n set for count n (0..8).
+inline uint16_t rule_mask(const godot::TypedArray<int> &counts) {
+    uint16_t mask = 0;
+    for (int i = 0; i < counts.size(); i++) {
+        int val = counts[i];
+        if (val >= 0 && val < 9) {
+            mask |= static_cast<uint16_t>(1 << val);
+        }
+    }
+    return mask;
+}
+
+} // namespace automata
@@ -0,0 +1,135 @@
+#include "native_hashlife.h"
+
+#include <algorithm>
+
+#include "native_common.h"
+#include "step_budget.h"
+
+namespace godot {
+
+void NativeHashLife::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_rule", "birth", "survive"), &NativeHashLife::set_rule);
+    ClassDB::bind_method(D_METHOD("clear"), &NativeHashLife::clear);
+    ClassDB::bind_method(D_METHOD("load_grid", "grid", "size", "position"), &NativeHashLife::load_grid, DEFVAL(Vector2i()));
+    ClassDB::bind_method(D_METHOD("read_region", "region"), &NativeHashLife::read_region);
+    ClassDB::bind_method(D_METHOD("set_step_log2", "step_log2"), &NativeHashLife::set_step_log2);
+    ClassDB::bind_method(D_METHOD("get_step_log2"), &NativeHashLife::get_step_log2);
+    ClassDB::bind_method(D_METHOD("step"), &NativeHashLife::step);
+    ClassDB::bind_method(D_METHOD("run_for", "budget_usec", "max_steps"), &NativeHashLife::run_for, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_generation"), &NativeHashLife::get_generation);
+    ClassDB::bind_method(D_METHOD("get_population"), &NativeHashLife::get_population);
+    ClassDB::bind_method(D_METHOD("set_max_nodes", "count"), &NativeHashLife::set_max_nodes);
+    ClassDB::bind_method(D_METHOD("get_max_nodes"), &NativeHashLife::get_max_nodes);
+    ClassDB::bind_method(D_METHOD("collect_garbage"), &NativeHashLife::collect_garbage);
+    ClassDB::bind_method(D_METHOD("get_stats"), &NativeHashLife::get_stats);
+    ClassDB::bind_method(D_METHOD("reset_stats"), &NativeHashLife::reset_stats);
+}
+
+NativeHashLife::NativeHashLife() :
+        life(std::make_unique<automata::HashLife>()) {
+}
+
+// Returns false when the rule contains B0 (the rule is left unchanged).
+bool NativeHashLife::set_rule(const TypedArray<int> &birth, const TypedArray<int> &survive) {
+    return life->set_rule(automata::rule_mask(birth), automata::rule_mask(survive));
+}
+
+void NativeHashLife::clear() {
+    life->clear();
+}
+
+// Replaces the universe with `grid`, placing its top-left cell at `position`.
+bool NativeHashLife::load_grid(const PackedByteArray &grid, Vector2i size, Vector2i position) {
+    if (size.x <= 0 || size.y <= 0 || grid.size() != size.x * size.y) {
+        return false;
+    }
+    life->load(grid.ptr(), size.x, size.y, position.x, position.y);
+    return true;
+}
+
+PackedByteArray NativeHashLife::read_region(Rect2i region) const {
+    PackedByteArray cells;
+    if (region.size.x <= 0 || region.size.y <= 0) {
+        return cells;
+    }
+    cells.resize(static_cast<int64_t>(region.size.x) * region.size.y);
+    life->read(cells.ptrw(), region.position.x, region.position.y, region.size.x, region.size.y);
+    return cells;
+}
+
+// Returns false, leaving the step unchanged, unless 0 <= step_log2 <= 58.
+bool NativeHashLife::set_step_log2(int step_log2) {
+    return life->set_step_log2(step_log2);
+}
+
+int NativeHashLife::get_step_log2() const {
+    return life->get_step_log2();
+}
+
+// Advances 2^step_log2 generations and returns the new generation count, which stays the same
+// once the pattern has spread past the 2^62-cell plane.
+int64_t NativeHashLife::step() {
+    life->step();
+    return static_cast<int64_t>(life->get_generation());
+}
+
+// Calls step() while the average step still fits in `budget_usec` microseconds, at most
+// `max_steps` times (0 = no cap). Returns the number of steps run, at least one unless the
+// pattern has spread past the 2^62-cell plane.
+int64_t NativeHashLife::run_for(int64_t budget_usec, int64_t max_steps) {
+    automata::StepBudget budget(budget_usec, max_steps);
+    int64_t steps = 0;
+    while (budget.take() > 0) {
+        if (!life->step()) {
+            break;
+        }
+        steps++;
+    }
+    return steps;
+}
+
+int64_t NativeHashLife::get_generation() const {
+    return static_cast<int64_t>(life->get_generation());
+}
+
+int64_t NativeHashLife::get_population() const {
+    return static_cast<int64_t>(life->get_population());
+}
+
+// Node budget that triggers a collection before the next step (0 = never collect).
+void NativeHashLife::set_max_nodes(int count) {
+    life->set_max_nodes(static_cast<uint32_t>(std::max(0, count)));
+}
+
+int NativeHashLife::get_max_nodes() const {
+    return static_cast<int>(life->get_max_nodes());
+}
+
+void NativeHashLife::collect_garbage() {
+    life->collect_garbage();
+}
+
+Dictionary NativeHashLife::get_stats() const {
+    const automata::HashLife::Stats &stats = life->get_stats();
+    const uint64_t joins = stats.join_hits + stats.join_misses;
+    const uint64_t results = stats.result_hits + stats.result_misses;
+
+    Dictionary result;
+    result["nodes"] = static_cast<int64_t>(life->get_node_count());
+    result["max_nodes"] = static_cast<int64_t>(life->get_max_nodes());
+    result["root_level"] = life->get_root_level();
+    result["node_hits"] = static_cast<int64_t>(stats.join_hits);
+    result["node_misses"] = static_cast<int64_t>(stats.join_misses);
+    result["node_hit_rate"] = joins > 0 ? static_cast<double>(stats.join_hits) / joins : 0.0;
+    result["result_hits"] = static_cast<int64_t>(stats.result_hits);
+    result["result_misses"] = static_cast<int64_t>(stats.result_misses);
+    result["result_hit_rate"] = results > 0 ? static_cast<double>(stats.result_hits) / results : 0.0;
+    result["collections"] = static_cast<int64_t>(stats.collections);
+    return result;
+}
+
+void NativeHashLife::reset_stats() {
+    life->reset_stats();
+}
+
+} // namespace godot
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/rect2i.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+
+#include <memory>
+
+#include "hashlife.h"
+
+namespace godot {
+
+// HashLife engine for B3/S23 and other Life-like rules without B0 on an unbounded plane.
+// Import a byte grid with load_grid(), advance 2^step_log2 generations per step(), and read any
+// rectangle back with read_region().
+class NativeHashLife : public RefCounted {
+    GDCLASS(NativeHashLife, RefCounted);
+
+    std::unique_ptr<automata::HashLife> life;
+
+protected:
+    static void _bind_methods();
+
+public:
+    NativeHashLife();
+
+    bool set_rule(const TypedArray<int> &birth, const TypedArray<int> &survive);
+    void clear();
+    bool load_grid(const PackedByteArray &grid, Vector2i size, Vector2i position);
+    PackedByteArray read_region(Rect2i region) const;
+
+    bool set_step_log2(int step_log2);
+    int get_step_log2() const;
+    int64_t step();
+    int64_t run_for(int64_t budget_usec, int64_t max_steps);
+
+    int64_t get_generation() const;
+    int64_t get_population() const;
+
+    void set_max_nodes(int count);
+    int get_max_nodes() const;
+    void collect_garbage();
+
+    Dictionary get_stats() const;
+    void reset_stats();
+};
+
+} // namespace godot
@@ -0,0 +1,212 @@
+#include "native_sandpile.h"
+
+#include <algorithm>
+
+#include "step_budget.h"
+
+namespace godot {
+
+namespace {
+
+PackedInt64Array to_packed(const automata::SandAvalancheStats::Histogram &histogram) {
+    PackedInt64Array packed;
+    packed.resize(automata::SandAvalancheStats::BINS);
+    std::copy(histogram.begin(), histogram.end(), packed.ptrw());
+    return packed;
+}
+
+Dictionary to_dictionary(const automata::SandAvalanche &avalanche) {
+    Dictionary result;
+    result["topples"] = avalanche.topples;
+    result["area"] = avalanche.area;
+    result["duration"] = avalanche.duration;
+    return result;
+}
+
+// Grid area from which relax() spreads avalanches over the worker pool; smaller piles have too
+// few tiles per color phase to keep several threads busy.
+constexpr int64_t PARALLEL_RELAX_MIN_AREA = 256 * 256;
+
+} // namespace
+
+void NativeSandpile::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("sync_grid", "grid", "size", "edge_mode"), &NativeSandpile::sync_grid);
+    ClassDB::bind_method(D_METHOD("set_rule", "threshold", "neighborhood"), &NativeSandpile::set_rule);
+    ClassDB::bind_method(D_METHOD("get_threshold"), &NativeSandpile::get_threshold);
+    ClassDB::bind_method(D_METHOD("get_neighborhood"), &NativeSandpile::get_neighborhood);
+    ClassDB::bind_method(D_METHOD("get_grid"), &NativeSandpile::get_grid);
+    ClassDB::bind_method(D_METHOD("get_size"), &NativeSandpile::get_size);
+    ClassDB::bind_method(D_METHOD("clear"), &NativeSandpile::clear);
+    ClassDB::bind_method(D_METHOD("add_grains", "position", "amount"), &NativeSandpile::add_grains);
+    ClassDB::bind_method(D_METHOD("step"), &NativeSandpile::step);
+    ClassDB::bind_method(D_METHOD("run_for", "budget_usec", "max_steps"), &NativeSandpile::run_for, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("relax", "max_topples"), &NativeSandpile::relax, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("is_stable"), &NativeSandpile::is_stable);
+    ClassDB::bind_method(D_METHOD("get_unstable_count"), &NativeSandpile::get_unstable_count);
+    ClassDB::bind_method(D_METHOD("set_thread_count", "count"), &NativeSandpile::set_thread_count);
+    ClassDB::bind_method(D_METHOD("get_thread_count"), &NativeSandpile::get_thread_count);
+    ClassDB::bind_method(D_METHOD("set_avalanche_stats_enabled", "enabled"), &NativeSandpile::set_avalanche_stats_enabled);
+    ClassDB::bind_method(D_METHOD("is_avalanche_stats_enabled"), &NativeSandpile::is_avalanche_stats_enabled);
+    ClassDB::bind_method(D_METHOD("get_avalanche_stats"), &NativeSandpile::get_avalanche_stats);
+    ClassDB::bind_method(D_METHOD("get_cell_topples"), &NativeSandpile::get_cell_topples);
+    ClassDB::bind_method(D_METHOD("reset_avalanche_stats"), &NativeSandpile::reset_avalanche_stats);
+}
+
+NativeSandpile::NativeSandpile() :
+        pile(std::make_unique<automata::SandPile>()) {
+}
+
+// Adopts `grid` unless it is the array get_grid() returned last (edits made to that array in
+// script give it a new buffer, so they are picked up). Returns true when the cells were reloaded.
+bool NativeSandpile::sync_grid(const PackedInt32Array &grid, Vector2i size, int edge_mode) {
+    pile->set_edge_mode(edge_mode);
+    if (size.x <= 0 || size.y <= 0 || grid.size() != size.x * size.y) {
+        return false;
+    }
+    if (!output_dirty && grid.ptr() == output.ptr() && size == get_size()) {
+        return false;
+    }
+    if (size != get_size()) {
+        pile->resize(size.x, size.y);
+    }
+    pile->load(grid.ptr());
+    output = grid;
+    output_dirty = false;
+    return true;
+}
+
+// Toppling threshold and neighborhood (0 von Neumann, 1 Moore), as in NativeAutomata.step_sand.
+// Returns false and keeps the current rule when the threshold is below the neighbor count.
+bool NativeSandpile::set_rule(int32_t threshold, int neighborhood) {
+    const automata::SandRule rule{ threshold, neighborhood };
+    if (!automata::sand_rule_valid(rule)) {
+        return false;
+    }
+    pile->set_rule(rule);
+    return true;
+}
+
+int32_t NativeSandpile::get_threshold() const {
+    return pile->get_rule().threshold;
+}
+
+int NativeSandpile::get_neighborhood() const {
+    return pile->get_rule().neighborhood;
+}
+
+PackedInt32Array NativeSandpile::get_grid() {
+    if (output_dirty) {
+        // A fresh array, so copies held by scripts keep their contents.
+        output = PackedInt32Array();
+        output.resize(static_cast<int64_t>(pile->get_width()) * pile->get_height());
+        pile->store(output.ptrw());
+        output_dirty = false;
+    }
+    return output;
+}
+
+Vector2i NativeSandpile::get_size() const {
+    return Vector2i(pile->get_width(), pile->get_height());
+}
+
+void NativeSandpile::clear() {
+    pile->resize(pile->get_width(), pile->get_height());
+    output_dirty = true;
+}
+
+void NativeSandpile::add_grains(Vector2i position, int amount) {
+    if (position.x < 0 || position.x >= pile->get_width() || position.y < 0 || position.y >= pile->get_height() || amount <= 0) {
+        return;
+    }
+    pile->add(position.x, position.y, amount);
+    output_dirty = true;
+}
+
+// One synchronous wave, matching NativeAutomata.step_sand. Returns true when anything toppled.
+bool NativeSandpile::step() {
+    const bool changed = pile->step();
+    output_dirty |= changed;
+    return changed;
+}
+
+// Runs step() waves while the average wave still fits in `budget_usec` microseconds, at most
+// `max_steps` of them (0 = no cap), stopping early once the pile is stable. Returns the waves
+// that toppled something.
+int64_t NativeSandpile::run_for(int64_t budget_usec, int64_t max_steps) {
+    automata::StepBudget budget(budget_usec, max_steps);
+    int64_t waves = 0;
+    while (!pile->is_stable() && budget.take() > 0) {
+        waves += pile->step();
+    }
+    output_dirty |= waves > 0;
+    return waves;
+}
+
+// Relaxes toward stability; see SandPile::relax. Keys: "changed", "topples" and "stable".
+Dictionary NativeSandpile::relax(int64_t max_topples) {
+    const bool parallel = pool.get_thread_count() > 1 && static_cast<int64_t>(pile->get_width()) * pile->get_height() >= PARALLEL_RELAX_MIN_AREA;
+    const automata::SandRelaxResult relaxed = parallel ? pile->relax_parallel(max_topples, pool) : pile->relax(max_topples);
+    output_dirty |= relaxed.topples > 0;
+
+    Dictionary result;
+    result["changed"] = relaxed.topples > 0;
+    result["topples"] = relaxed.topples;
+    result["stable"] = relaxed.stable;
+    return result;
+}
+
+bool NativeSandpile::is_stable() const {
+    return pile->is_stable();
+}
+
+int64_t NativeSandpile::get_unstable_count() const {
+    return static_cast<int64_t>(pile->get_unstable_count());
+}
+
+// Threads used by relax(), including the caller. 0 picks the hardware thread count.
+void NativeSandpile::set_thread_count(int count) {
+    pool.set_thread_count(std::max(0, count));
+}
+
+int NativeSandpile::get_thread_count() const {
+    return pool.get_thread_count();
+}
+
+// Enabling allocates the per-cell tables and starts from empty histograms; disabling frees them.
+void NativeSandpile::set_avalanche_stats_enabled(bool enabled) {
+    pile->set_recording(enabled);
+}
+
+bool NativeSandpile::is_avalanche_stats_enabled() const {
+    return pile->is_recording();
+}
+
+// Keys: "avalanches" (finished avalanches), "size_histogram", "area_histogram" and
+// "duration_histogram" (64 log2 bins: bin 0 holds 0, bin k holds [2^(k-1), 2^k)), and "last" and
+// "largest" with "topples", "area" and "duration".
+Dictionary NativeSandpile::get_avalanche_stats() const {
+    const automata::SandAvalancheStats &stats = pile->get_stats();
+    Dictionary result;
+    result["avalanches"] = stats.get_avalanche_count();
+    result["size_histogram"] = to_packed(stats.get_size_histogram());
+    result["area_histogram"] = to_packed(stats.get_area_histogram());
+    result["duration_histogram"] = to_packed(stats.get_duration_histogram());
+    result["last"] = to_dictionary(stats.get_last());
+    result["largest"] = to_dictionary(stats.get_largest());
+    return result;
+}
+
+// Topples per cell since the last reset, row-major; empty while statistics are disabled.
+PackedInt64Array NativeSandpile::get_cell_topples() const {
+    const std::vector<int64_t> &totals = pile->get_stats().get_cell_topples();
+    PackedInt64Array packed;
+    packed.resize(static_cast<int64_t>(totals.size()));
+    std::copy(totals.begin(), totals.end(), packed.ptrw());
+    return packed;
+}
+
+void NativeSandpile::reset_avalanche_stats() {
+    pile->reset_stats();
+}
+
+} // namespace godot
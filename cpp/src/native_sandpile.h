@@ -0,0 +1,63 @@
+#pragma once
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+
+#include <memory>
+
+#include "sand_pile.h"
+#include "worker_pool.h"
+
+namespace godot {
+
+// Persistent sandpile driven by a worklist of unstable cells (see sand_pile.h). Keep the grid in
+// sync with sync_grid(), which only reloads when the array is not the one get_grid() returned
+// last, then step() or relax(); a stable pile returns from both after one check. Large
+// avalanches relax on several threads (see sand_tiles.h). Avalanche statistics are off by default
+// and cost nothing until enabled (see sand_stats.h).
+class NativeSandpile : public RefCounted {
+    GDCLASS(NativeSandpile, RefCounted);
+
+    std::unique_ptr<automata::SandPile> pile;
+    automata::WorkerPool pool;
+    // Last array handed out by get_grid(); rebuilt only after the pile changed.
+    PackedInt32Array output;
+    bool output_dirty = true;
+
+protected:
+    static void _bind_methods();
+
+public:
+    NativeSandpile();
+
+    bool sync_grid(const PackedInt32Array &grid, Vector2i size, int edge_mode);
+    bool set_rule(int32_t threshold, int neighborhood);
+    int32_t get_threshold() const;
+    int get_neighborhood() const;
+    PackedInt32Array get_grid();
+    Vector2i get_size() const;
+    void clear();
+
+    void add_grains(Vector2i position, int amount);
+    bool step();
+    int64_t run_for(int64_t budget_usec, int64_t max_steps);
+    Dictionary relax(int64_t max_topples);
+
+    bool is_stable() const;
+    int64_t get_unstable_count() const;
+
+    void set_thread_count(int count);
+    int get_thread_count() const;
+
+    void set_avalanche_stats_enabled(bool enabled);
+    bool is_avalanche_stats_enabled() const;
+    Dictionary get_avalanche_stats() const;
+    PackedInt64Array get_cell_topples() const;
+    void reset_avalanche_stats();
+};
+
+} // namespace godot
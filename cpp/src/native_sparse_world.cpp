@@ -0,0 +1,178 @@
+#include "native_sparse_world.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "native_common.h"
+#include "step_budget.h"
+
+namespace godot {
+
+namespace {
+
+// Walkers cross the API as Vector2i, so positions stay within 32 bits.
+void read_walkers(const TypedArray<Vector2i> &ants, const TypedArray<int> &directions, std::vector<automata::SparseWorld::Walker> &walkers) {
+    const int64_t count = std::min<int64_t>(ants.size(), directions.size());
+    walkers.resize(static_cast<size_t>(count));
+    for (int64_t i = 0; i < count; i++) {
+        const Vector2i pos = ants[i];
+        walkers[i] = { pos.x, pos.y, static_cast<int>(directions[i]) };
+    }
+}
+
+Dictionary write_walkers(const std::vector<automata::SparseWorld::Walker> &walkers, const TypedArray<Color> &colors, bool changed) {
+    TypedArray<Vector2i> next_ants;
+    TypedArray<int> next_dirs;
+    TypedArray<Color> next_colors;
+    for (size_t i = 0; i < walkers.size(); i++) {
+        next_ants.push_back(Vector2i(static_cast<int32_t>(walkers[i].x), static_cast<int32_t>(walkers[i].y)));
+        next_dirs.push_back(walkers[i].dir);
+        if (static_cast<int64_t>(i) < colors.size()) {
+            next_colors.push_back(colors[i]);
+        } else {
+            next_colors.push_back(Color(1.0, 1.0, 1.0, 1.0));
+        }
+    }
+
+    Dictionary result;
+    result["ants"] = next_ants;
+    result["directions"] = next_dirs;
+    result["colors"] = next_colors;
+    result["changed"] = changed;
+    return result;
+}
+
+} // namespace
+
+void NativeSparseWorld::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("clear"), &NativeSparseWorld::clear);
+    ClassDB::bind_method(D_METHOD("get_cell", "position"), &NativeSparseWorld::get_cell);
+    ClassDB::bind_method(D_METHOD("set_cell", "position", "value"), &NativeSparseWorld::set_cell);
+    ClassDB::bind_method(D_METHOD("write_grid", "grid", "size", "position"), &NativeSparseWorld::write_grid, DEFVAL(Vector2i()));
+    ClassDB::bind_method(D_METHOD("read_region", "region"), &NativeSparseWorld::read_region);
+    ClassDB::bind_method(D_METHOD("step_totalistic", "birth", "survive", "generations"), &NativeSparseWorld::step_totalistic, DEFVAL(1));
+    ClassDB::bind_method(D_METHOD("run_totalistic_for", "birth", "survive", "budget_usec", "max_generations"), &NativeSparseWorld::run_totalistic_for, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("step_ants", "ants", "directions", "colors"), &NativeSparseWorld::step_ants);
+    ClassDB::bind_method(D_METHOD("step_turmites", "ants", "directions", "colors", "rule"), &NativeSparseWorld::step_turmites);
+    ClassDB::bind_method(D_METHOD("get_chunk_size"), &NativeSparseWorld::get_chunk_size);
+    ClassDB::bind_method(D_METHOD("get_chunk_count"), &NativeSparseWorld::get_chunk_count);
+    ClassDB::bind_method(D_METHOD("get_population"), &NativeSparseWorld::get_population);
+    ClassDB::bind_method(D_METHOD("get_bounds"), &NativeSparseWorld::get_bounds);
+    ClassDB::bind_method(D_METHOD("set_thread_count", "count"), &NativeSparseWorld::set_thread_count);
+    ClassDB::bind_method(D_METHOD("get_thread_count"), &NativeSparseWorld::get_thread_count);
+}
+
+NativeSparseWorld::NativeSparseWorld() :
+        world(std::make_unique<automata::SparseWorld>()) {
+}
+
+void NativeSparseWorld::clear() {
+    world->clear();
+}
+
+int NativeSparseWorld::get_cell(Vector2i position) const {
+    return world->get_cell(position.x, position.y);
+}
+
+void NativeSparseWorld::set_cell(Vector2i position, int value) {
+    world->set_cell(position.x, position.y, static_cast<uint8_t>(std::clamp(value, 0, 1)));
+}
+
+// Copies `grid` onto the plane with its top-left cell at `position`; zero cells clear.
+bool NativeSparseWorld::write_grid(const PackedByteArray &grid, Vector2i size, Vector2i position) {
+    if (size.x <= 0 || size.y <= 0 || grid.size() != size.x * size.y) {
+        return false;
+    }
+    world->write(grid.ptr(), size.x, size.y, position.x, position.y);
+    return true;
+}
+
+PackedByteArray NativeSparseWorld::read_region(Rect2i region) const {
+    PackedByteArray cells;
+    if (region.size.x <= 0 || region.size.y <= 0) {
+        return cells;
+    }
+    cells.resize(static_cast<int64_t>(region.size.x) * region.size.y);
+    world->read(cells.ptrw(), region.position.x, region.position.y, region.size.x, region.size.y);
+    return cells;
+}
+
+// Returns true when any cell changed. Rules with B0 are rejected (nothing happens).
+bool NativeSparseWorld::step_totalistic(const TypedArray<int> &birth, const TypedArray<int> &survive, int generations) {
+    const uint16_t birth_mask = automata::rule_mask(birth);
+    const uint16_t survive_mask = automata::rule_mask(survive);
+    bool changed = false;
+    for (int i = 0; i < generations; i++) {
+        changed |= world->step_totalistic(birth_mask, survive_mask, pool);
+    }
+    return changed;
+}
+
+// Advances generations while the average generation still fits in `budget_usec` microseconds, at
+// most `max_generations` of them (0 = no cap). Returns the generations run, at least one; rules
+// with B0 are rejected like in step_totalistic and run none.
+int64_t NativeSparseWorld::run_totalistic_for(const TypedArray<int> &birth, const TypedArray<int> &survive, int64_t budget_usec, int64_t max_generations) {
+    const uint16_t birth_mask = automata::rule_mask(birth);
+    const uint16_t survive_mask = automata::rule_mask(survive);
+    if (birth_mask & 1) {
+        return 0;
+    }
+    automata::StepBudget budget(budget_usec, max_generations);
+    while (budget.take() > 0) {
+        world->step_totalistic(birth_mask, survive_mask, pool);
+    }
+    return budget.get_steps();
+}
+
+Dictionary NativeSparseWorld::step_ants(const TypedArray<Vector2i> &ants, const TypedArray<int> &directions, const TypedArray<Color> &colors) {
+    std::vector<automata::SparseWorld::Walker> walkers;
+    read_walkers(ants, directions, walkers);
+    const bool changed = world->step_ants(walkers);
+    return write_walkers(walkers, colors, changed);
+}
+
+// Same turn string as NativeAutomata.step_turmites: "R" turns right on that cell state,
+// anything else turns left; only the first two states are used.
+Dictionary NativeSparseWorld::step_turmites(const TypedArray<Vector2i> &ants, const TypedArray<int> &directions, const TypedArray<Color> &colors, const String &rule) {
+    String upper_rule = rule.to_upper();
+    if (upper_rule.length() < 2) {
+        upper_rule = "RL";
+    }
+    const bool turns[2] = { upper_rule[0] == U'R', upper_rule[1] == U'R' };
+
+    std::vector<automata::SparseWorld::Walker> walkers;
+    read_walkers(ants, directions, walkers);
+    const bool changed = world->step_turmites(walkers, turns);
+    return write_walkers(walkers, colors, changed);
+}
+
+int NativeSparseWorld::get_chunk_size() const {
+    return automata::SparseWorld::CHUNK;
+}
+
+int64_t NativeSparseWorld::get_chunk_count() const {
+    return static_cast<int64_t>(world->get_chunk_count());
+}
+
+int64_t NativeSparseWorld::get_population() const {
+    return static_cast<int64_t>(world->get_population());
+}
+
+// Cell rectangle covered by allocated chunks (empty when the world is empty).
+Rect2i NativeSparseWorld::get_bounds() const {
+    int64_t x0, y0, x1, y1;
+    if (!world->get_bounds(x0, y0, x1, y1)) {
+        return Rect2i();
+    }
+    return Rect2i(static_cast<int32_t>(x0), static_cast<int32_t>(y0), static_cast<int32_t>(x1 - x0), static_cast<int32_t>(y1 - y0));
+}
+
+void NativeSparseWorld::set_thread_count(int count) {
+    pool.set_thread_count(std::max(0, count));
+}
+
+int NativeSparseWorld::get_thread_count() const {
+    return pool.get_thread_count();
+}
+
+} // namespace godot
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/color.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/rect2i.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+
+#include <memory>
+
+#include "sparse_world.h"
+#include "worker_pool.h"
+
+namespace godot {
+
+// Unbounded, chunk-allocated grid for totalistic rules, ants and turmites. Cells outside any
+// chunk are dead and chunks are freed once empty, so memory follows the live area. Exchange
+// cells with write_grid() / read_region(); the step methods mirror NativeAutomata's without the
+// size and edge mode (the plane is infinite).
+class NativeSparseWorld : public RefCounted {
+    GDCLASS(NativeSparseWorld, RefCounted);
+
+    std::unique_ptr<automata::SparseWorld> world;
+    automata::WorkerPool pool;
+
+protected:
+    static void _bind_methods();
+
+public:
+    NativeSparseWorld();
+
+    void clear();
+    int get_cell(Vector2i position) const;
+    void set_cell(Vector2i position, int value);
+    bool write_grid(const PackedByteArray &grid, Vector2i size, Vector2i position);
+    PackedByteArray read_region(Rect2i region) const;
+
+    bool step_totalistic(const TypedArray<int> &birth, const TypedArray<int> &survive, int generations);
+    int64_t run_totalistic_for(const TypedArray<int> &birth, const TypedArray<int> &survive, int64_t budget_usec, int64_t max_generations);
+    Dictionary step_ants(const TypedArray<Vector2i> &ants, const TypedArray<int> &directions, const TypedArray<Color> &colors);
+    Dictionary step_turmites(const TypedArray<Vector2i> &ants, const TypedArray<int> &directions, const TypedArray<Color> &colors, const String &rule);
+
+    int get_chunk_size() const;
+    int64_t get_chunk_count() const;
+    int64_t get_population() const;
+    Rect2i get_bounds() const;
+
+    void set_thread_count(int count);
+    int get_thread_count() const;
+};
+
+} // namespace godot
@@ -0,0 +1,279 @@
+#include "native_walkers.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace godot {
+
+namespace {
+
+constexpr size_t MAX_PALETTE = 256;
+
+uint64_t splitmix64(uint64_t &state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Uniform in [0, bound) from the high half of a 64-bit draw.
+int32_t draw_below(uint64_t &state, int32_t bound) {
+    return static_cast<int32_t>(((splitmix64(state) >> 32) * static_cast<uint64_t>(bound)) >> 32);
+}
+
+uint8_t to_byte(float channel) {
+    return static_cast<uint8_t>(std::clamp(channel, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+} // namespace
+
+void NativeWalkers::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("clear"), &NativeWalkers::clear);
+    ClassDB::bind_method(D_METHOD("get_count"), &NativeWalkers::get_count);
+    ClassDB::bind_method(D_METHOD("add_walker", "position", "direction", "color"), &NativeWalkers::add_walker);
+    ClassDB::bind_method(D_METHOD("add_walkers", "positions", "directions", "color"), &NativeWalkers::add_walkers);
+    ClassDB::bind_method(D_METHOD("spawn_random", "count", "size", "color", "seed"), &NativeWalkers::spawn_random);
+    ClassDB::bind_method(D_METHOD("remove_at", "position"), &NativeWalkers::remove_at);
+    ClassDB::bind_method(D_METHOD("remove_in_rect", "region"), &NativeWalkers::remove_in_rect);
+    ClassDB::bind_method(D_METHOD("has_walker_at", "position"), &NativeWalkers::has_walker_at);
+    ClassDB::bind_method(D_METHOD("wrap_positions", "size"), &NativeWalkers::wrap_positions);
+    ClassDB::bind_method(D_METHOD("step_ants", "grid", "size", "edge_mode", "steps"), &NativeWalkers::step_ants, DEFVAL(1));
+    ClassDB::bind_method(D_METHOD("step_turmites", "grid", "size", "edge_mode", "rule", "steps"), &NativeWalkers::step_turmites, DEFVAL(1));
+    ClassDB::bind_method(D_METHOD("get_positions"), &NativeWalkers::get_positions);
+    ClassDB::bind_method(D_METHOD("get_directions"), &NativeWalkers::get_directions);
+    ClassDB::bind_method(D_METHOD("get_palette_indices"), &NativeWalkers::get_palette_indices);
+    ClassDB::bind_method(D_METHOD("get_palette"), &NativeWalkers::get_palette);
+    ClassDB::bind_method(D_METHOD("get_colors"), &NativeWalkers::get_colors);
+    ClassDB::bind_method(D_METHOD("paint_overlay", "size", "above"), &NativeWalkers::paint_overlay, DEFVAL(Variant()));
+}
+
+// Exact matches reuse their entry; once the table is full a new colour maps to the closest one.
+uint8_t NativeWalkers::palette_index(const Color &color) {
+    for (size_t i = 0; i < palette.size(); i++) {
+        if (palette[i] == color) {
+            return static_cast<uint8_t>(i);
+        }
+    }
+    if (palette.size() < MAX_PALETTE) {
+        palette.push_back(color);
+        return static_cast<uint8_t>(palette.size() - 1);
+    }
+    size_t best = 0;
+    float best_distance = 0.0f;
+    for (size_t i = 0; i < palette.size(); i++) {
+        const float dr = palette[i].r - color.r;
+        const float dg = palette[i].g - color.g;
+        const float db = palette[i].b - color.b;
+        const float da = palette[i].a - color.a;
+        const float distance = dr * dr + dg * dg + db * db + da * da;
+        if (i == 0 || distance < best_distance) {
+            best = i;
+            best_distance = distance;
+        }
+    }
+    return static_cast<uint8_t>(best);
+}
+
+void NativeWalkers::clear() {
+    store.clear();
+    palette.clear();
+}
+
+int64_t NativeWalkers::get_count() const {
+    return static_cast<int64_t>(store.size());
+}
+
+void NativeWalkers::add_walker(Vector2i position, int direction, const Color &color) {
+    store.add(position.x, position.y, direction, palette_index(color));
+}
+
+// `positions` holds x, y pairs. Walkers without a direction face up. Returns the walkers added.
+int64_t NativeWalkers::add_walkers(const PackedInt32Array &positions, const PackedByteArray &directions, const Color &color) {
+    const int64_t count = positions.size() / 2;
+    if (count <= 0) {
+        return 0;
+    }
+    const uint8_t index = palette_index(color);
+    const int32_t *xy = positions.ptr();
+    const uint8_t *dirs = directions.ptr();
+    store.reserve(store.size() + static_cast<size_t>(count));
+    for (int64_t i = 0; i < count; i++) {
+        store.add(xy[i * 2], xy[i * 2 + 1], i < directions.size() ? dirs[i] : 0, index);
+    }
+    return count;
+}
+
+// `count` walkers at uniform positions in `size` with random directions; the same seed gives the
+// same walkers.
+void NativeWalkers::spawn_random(int64_t count, Vector2i size, const Color &color, int64_t seed) {
+    if (count <= 0 || size.x <= 0 || size.y <= 0) {
+        return;
+    }
+    const uint8_t index = palette_index(color);
+    uint64_t state = static_cast<uint64_t>(seed);
+    store.reserve(store.size() + static_cast<size_t>(count));
+    for (int64_t i = 0; i < count; i++) {
+        const int32_t x = draw_below(state, size.x);
+        const int32_t y = draw_below(state, size.y);
+        store.add(x, y, draw_below(state, 4), index);
+    }
+}
+
+int64_t NativeWalkers::remove_at(Vector2i position) {
+    return static_cast<int64_t>(store.remove_in_rect(position.x, position.y, position.x + 1, position.y + 1));
+}
+
+int64_t NativeWalkers::remove_in_rect(Rect2i region) {
+    if (region.size.x <= 0 || region.size.y <= 0) {
+        return 0;
+    }
+    const Vector2i end = region.get_end();
+    return static_cast<int64_t>(store.remove_in_rect(region.position.x, region.position.y, end.x, end.y));
+}
+
+bool NativeWalkers::has_walker_at(Vector2i position) const {
+    return store.any_at(position.x, position.y);
+}
+
+void NativeWalkers::wrap_positions(Vector2i size) {
+    store.wrap(size.x, size.y);
+}
+
+// Runs `steps` moves on a copy of `grid`. Keys: "grid", "changed", "removed" (walkers that fell
+// off or started outside the grid) and "count" (walkers left).
+Dictionary NativeWalkers::step(const PackedByteArray &grid, Vector2i size, int edge_mode, const bool turns[2], int64_t steps) {
+    Dictionary result;
+    bool changed = false;
+    int64_t removed = 0;
+    if (size.x <= 0 || size.y <= 0 || grid.size() != size.x * size.y || store.empty() || steps <= 0) {
+        result["grid"] = grid;
+    } else {
+        PackedByteArray next_grid = grid;
+        uint8_t *cells = next_grid.ptrw();
+        for (int64_t i = 0; i < steps && !store.empty(); i++) {
+            const automata::WalkerStep moved = store.step(cells, size.x, size.y, edge_mode, turns);
+            changed |= moved.changed || moved.removed > 0;
+            removed += static_cast<int64_t>(moved.removed);
+        }
+        result["grid"] = next_grid;
+    }
+    result["changed"] = changed;
+    result["removed"] = removed;
+    result["count"] = get_count();
+    return result;
+}
+
+Dictionary NativeWalkers::step_ants(const PackedByteArray &grid, Vector2i size, int edge_mode, int64_t steps) {
+    const bool turns[2] = { false, true };
+    return step(grid, size, edge_mode, turns, steps);
+}
+
+// Same turn string as NativeAutomata.step_turmites: "R" turns right on that cell state, anything
+// else turns left; only the first two states are used.
+Dictionary NativeWalkers::step_turmites(const PackedByteArray &grid, Vector2i size, int edge_mode, const String &rule, int64_t steps) {
+    String upper_rule = rule.to_upper();
+    if (upper_rule.length() < 2) {
+        upper_rule = "RL";
+    }
+    const bool turns[2] = { upper_rule[0] == U'R', upper_rule[1] == U'R' };
+    return step(grid, size, edge_mode, turns, steps);
+}
+
+// x, y pairs in walker order.
+PackedInt32Array NativeWalkers::get_positions() const {
+    PackedInt32Array positions;
+    const size_t count = store.size();
+    positions.resize(static_cast<int64_t>(count * 2));
+    int32_t *xy = positions.ptrw();
+    const int32_t *xs = store.get_x();
+    const int32_t *ys = store.get_y();
+    for (size_t i = 0; i < count; i++) {
+        xy[i * 2] = xs[i];
+        xy[i * 2 + 1] = ys[i];
+    }
+    return positions;
+}
+
+PackedByteArray NativeWalkers::get_directions() const {
+    PackedByteArray directions;
+    directions.resize(static_cast<int64_t>(store.size()));
+    if (!store.empty()) {
+        memcpy(directions.ptrw(), store.get_dirs(), store.size());
+    }
+    return directions;
+}
+
+PackedByteArray NativeWalkers::get_palette_indices() const {
+    PackedByteArray indices;
+    indices.resize(static_cast<int64_t>(store.size()));
+    if (!store.empty()) {
+        memcpy(indices.ptrw(), store.get_palette(), store.size());
+    }
+    return indices;
+}
+
+PackedColorArray NativeWalkers::get_palette() const {
+    PackedColorArray colors;
+    for (const Color &color : palette) {
+        colors.push_back(color);
+    }
+    return colors;
+}
+
+// One colour per walker, resolved through the palette.
+PackedColorArray NativeWalkers::get_colors() const {
+    PackedColorArray colors;
+    const size_t count = store.size();
+    colors.resize(static_cast<int64_t>(count));
+    Color *out = colors.ptrw();
+    const uint8_t *indices = store.get_palette();
+    for (size_t i = 0; i < count; i++) {
+        out[i] = palette[indices[i]];
+    }
+    return colors;
+}
+
+// An RGBA8 image of `size` (Image.FORMAT_RGBA8 layout) holding each walker's colour, later
+// walkers on top, with the walkers of `above` painted over this store's, so ants and turmites
+// share one image and one call. Returns an empty array when neither store holds a walker; the
+// caller then builds its blank image wherever it likes instead of receiving a zeroed one.
+PackedByteArray NativeWalkers::paint_overlay(Vector2i size, const Ref<NativeWalkers> &above) const {
+    PackedByteArray image;
+    const bool paint_above = above.is_valid() && !above->store.empty();
+    if (size.x <= 0 || size.y <= 0 || (store.empty() && !paint_above)) {
+        return image;
+    }
+    image.resize(static_cast<int64_t>(size.x) * size.y * 4);
+    image.fill(0);
+    uint8_t *dst = image.ptrw();
+    paint_into(dst, size);
+    if (paint_above) {
+        above->paint_into(dst, size);
+    }
+    return image;
+}
+
+void NativeWalkers::paint_into(uint8_t *dst, Vector2i size) const {
+    if (store.empty()) {
+        return;
+    }
+    uint8_t rgba[MAX_PALETTE][4];
+    for (size_t i = 0; i < palette.size(); i++) {
+        rgba[i][0] = to_byte(palette[i].r);
+        rgba[i][1] = to_byte(palette[i].g);
+        rgba[i][2] = to_byte(palette[i].b);
+        rgba[i][3] = to_byte(palette[i].a);
+    }
+
+    const int32_t *xs = store.get_x();
+    const int32_t *ys = store.get_y();
+    const uint8_t *indices = store.get_palette();
+    for (size_t i = 0; i < store.size(); i++) {
+        if (xs[i] < 0 || xs[i] >= size.x || ys[i] < 0 || ys[i] >= size.y) {
+            continue;
+        }
+        memcpy(dst + (static_cast<int64_t>(ys[i]) * size.x + xs[i]) * 4, rgba[indices[i]], 4);
+    }
+}
+
+} // namespace godot
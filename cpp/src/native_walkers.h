@@ -0,0 +1,62 @@
+#pragma once
+
+#include <godot_cpp/classes/ref.hpp>
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/color.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_color_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/rect2i.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+
+#include <vector>
+
+#include "walkers.h"
+
+namespace godot {
+
+// Ants or turmites kept in extension memory between steps (see walkers.h). NativeAutomata's
+// step_ants/step_turmites take and return three Variant arrays per call; here walkers are added
+// and removed in bulk, a step passes only the grid, and positions, directions or colours are
+// exported as packed arrays when a script asks for them. Colours go through a palette of at most
+// 256 entries; further colours share the nearest entry.
+class NativeWalkers : public RefCounted {
+    GDCLASS(NativeWalkers, RefCounted);
+
+    automata::WalkerStore store;
+    std::vector<Color> palette;
+
+    uint8_t palette_index(const Color &color);
+    Dictionary step(const PackedByteArray &grid, Vector2i size, int edge_mode, const bool turns[2], int64_t steps);
+    void paint_into(uint8_t *dst, Vector2i size) const;
+
+protected:
+    static void _bind_methods();
+
+public:
+    void clear();
+    int64_t get_count() const;
+
+    void add_walker(Vector2i position, int direction, const Color &color);
+    int64_t add_walkers(const PackedInt32Array &positions, const PackedByteArray &directions, const Color &color);
+    void spawn_random(int64_t count, Vector2i size, const Color &color, int64_t seed);
+    int64_t remove_at(Vector2i position);
+    int64_t remove_in_rect(Rect2i region);
+    bool has_walker_at(Vector2i position) const;
+    void wrap_positions(Vector2i size);
+
+    Dictionary step_ants(const PackedByteArray &grid, Vector2i size, int edge_mode, int64_t steps);
+    Dictionary step_turmites(const PackedByteArray &grid, Vector2i size, int edge_mode, const String &rule, int64_t steps);
+
+    PackedInt32Array get_positions() const;
+    PackedByteArray get_directions() const;
+    PackedByteArray get_palette_indices() const;
+    PackedColorArray get_palette() const;
+    PackedColorArray get_colors() const;
+    PackedByteArray paint_overlay(Vector2i size, const Ref<NativeWalkers> &above) const;
+};
+
+} // namespace godot
@@ -0,0 +1,126 @@
+#include "native_wolfram.h"
+
+#include "automata_common.h"
+#include "wolfram.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace godot {
+
+void NativeWolfram::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("sync_grid", "grid", "size"), &NativeWolfram::sync_grid);
+    ClassDB::bind_method(D_METHOD("get_grid"), &NativeWolfram::get_grid);
+    ClassDB::bind_method(D_METHOD("get_size"), &NativeWolfram::get_size);
+    ClassDB::bind_method(D_METHOD("step", "rule", "row", "edge_mode", "allow_wrap"), &NativeWolfram::step);
+    ClassDB::bind_method(D_METHOD("step_rows", "rule", "row", "count", "edge_mode", "allow_wrap"), &NativeWolfram::step_rows);
+    ClassDB::bind_method(D_METHOD("scroll_rows", "rule", "count", "edge_mode"), &NativeWolfram::scroll_rows);
+    ClassDB::bind_method(D_METHOD("set_head", "row"), &NativeWolfram::set_head);
+    ClassDB::bind_method(D_METHOD("get_head"), &NativeWolfram::get_head);
+    ClassDB::bind_method(D_METHOD("unroll"), &NativeWolfram::unroll);
+}
+
+// Adopts `grid` unless it is the array get_grid() returned last (edits made to that array in
+// script give it a new buffer, so they are picked up). Returns true when the cells were reloaded.
+bool NativeWolfram::sync_grid(const PackedByteArray &grid, Vector2i p_size) {
+    if (p_size.x <= 0 || p_size.y <= 0 || grid.size() != p_size.x * p_size.y) {
+        return false;
+    }
+    if (!output_dirty && grid.ptr() == output.ptr() && p_size == size) {
+        return false;
+    }
+    if (p_size != size) {
+        head = 0;
+    }
+    size = p_size;
+    cells.resize(static_cast<size_t>(grid.size()));
+    memcpy(cells.data(), grid.ptr(), cells.size());
+    output = grid;
+    output_dirty = false;
+    return true;
+}
+
+PackedByteArray NativeWolfram::get_grid() {
+    if (output_dirty) {
+        // A fresh array, so copies held by scripts keep their contents.
+        output = PackedByteArray();
+        output.resize(static_cast<int64_t>(cells.size()));
+        memcpy(output.ptrw(), cells.data(), cells.size());
+        output_dirty = false;
+    }
+    return output;
+}
+
+Vector2i NativeWolfram::get_size() const {
+    return size;
+}
+
+// Writes row `row` from the row above it, with the row wrapping and source-row rules of
+// NativeAutomata.step_wolfram. Same keys as step_rows().
+Dictionary NativeWolfram::step(int32_t rule, int32_t row, int edge_mode, bool allow_wrap) {
+    return step_rows(rule, row, 1, edge_mode, allow_wrap);
+}
+
+// Writes up to `count` rows from `row` on (see automata::step_wolfram_rows). Keys: "row" (the next
+// row to write), "rows" (rows written), "changed", and "dirty_begin" / "dirty_end", the half-open
+// range of rows written; a sweep that wrapped past the last row reports the whole grid.
+Dictionary NativeWolfram::step_rows(int32_t rule, int32_t row, int64_t count, int edge_mode, bool allow_wrap) {
+    Dictionary result;
+    int32_t current_row = row;
+    if (allow_wrap && size.y > 0) {
+        current_row = automata::wrap_axis(current_row, size.y);
+    }
+    const int64_t written = automata::step_wolfram_rows(cells.data(), size.x, size.y, rule, current_row, count, edge_mode, allow_wrap);
+    output_dirty |= written > 0;
+
+    int64_t dirty_begin = current_row;
+    int64_t dirty_end = current_row + written;
+    int64_t next_row = dirty_end;
+    if (written == 0) {
+        dirty_begin = 0;
+        dirty_end = 0;
+        next_row = current_row;
+    } else if (allow_wrap) {
+        next_row = dirty_end % size.y;
+        if (dirty_end > size.y) {
+            dirty_begin = 0;
+            dirty_end = size.y;
+        }
+    }
+    result["row"] = next_row;
+    result["rows"] = written;
+    result["changed"] = written > 0;
+    result["dirty_begin"] = dirty_begin;
+    result["dirty_end"] = dirty_end;
+    return result;
+}
+
+// Writes `count` rows at the head of the ring, each from the row before it, and advances the head
+// past them. Keys: "head" (the new head, i.e. the display row offset), "rows", "changed" and
+// "dirty_begin" / "dirty_end" in storage rows, as in step_rows().
+Dictionary NativeWolfram::scroll_rows(int32_t rule, int64_t count, int edge_mode) {
+    Dictionary result = step_rows(rule, head, count, edge_mode, true);
+    head = result["row"];
+    result["head"] = head;
+    return result;
+}
+
+void NativeWolfram::set_head(int32_t row) {
+    head = size.y > 0 ? automata::wrap_axis(row, size.y) : 0;
+}
+
+int32_t NativeWolfram::get_head() const {
+    return head;
+}
+
+// Rotates the rows into display order (oldest first) and resets the head to 0.
+void NativeWolfram::unroll() {
+    if (head == 0 || cells.empty()) {
+        return;
+    }
+    std::rotate(cells.begin(), cells.begin() + static_cast<int64_t>(head) * size.x, cells.end());
+    head = 0;
+    output_dirty = true;
+}
+
+} // namespace godot
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// Wolfram sweep over a grid the extension owns. NativeAutomata.step_wolfram has to return a new
+// array, so every row costs a copy of the whole grid; here step() writes the row in place and
+// reports which rows it touched, and get_grid() copies once for however many rows ran since the
+// last call. sync_grid() follows NativeSandpile: the array get_grid() returned last is not reloaded.
+//
+// For an endless scrolling view the grid doubles as a ring of rows: scroll_rows() overwrites the
+// oldest row (the head) with the successor of the newest and advances the head, so the display
+// reads row (y + head) % height through the shader's state_row_offset instead of the grid moving
+// up by a row. unroll() rotates the storage back into display order when the view stops scrolling.
+class NativeWolfram : public RefCounted {
+    GDCLASS(NativeWolfram, RefCounted);
+
+    std::vector<uint8_t> cells;
+    Vector2i size;
+    // Oldest row of the ring; the newest is the row above it.
+    int32_t head = 0;
+    // Last array handed out by get_grid(); rebuilt only after a step wrote a row.
+    PackedByteArray output;
+    bool output_dirty = true;
+
+protected:
+    static void _bind_methods();
+
+public:
+    bool sync_grid(const PackedByteArray &grid, Vector2i p_size);
+    PackedByteArray get_grid();
+    Vector2i get_size() const;
+
+    Dictionary step(int32_t rule, int32_t row, int edge_mode, bool allow_wrap);
+    Dictionary step_rows(int32_t rule, int32_t row, int64_t count, int edge_mode, bool allow_wrap);
+
+    Dictionary scroll_rows(int32_t rule, int64_t count, int edge_mode);
+    void set_head(int32_t row);
+    int32_t get_head() const;
+    void unroll();
+};
+
+} // namespace godot
@@ -0,0 +1,150 @@
+#include "sand.h"
+
+#include "halo_grid.h"
+
+#include <utility>
+
+namespace automata {
+
+namespace {
+
+// Kernels are instantiated per neighborhood and per common threshold (4 for von Neumann, 8 for
+// Moore), so the classic piles divide by a constant; FIXED_THRESHOLD 0 reads the runtime value.
+// Edge modes need no instantiation: the halo ring already encodes them.
+template <int NEIGHBORS, int32_t FIXED_THRESHOLD>
+struct SandKernel {
+    int32_t runtime_threshold;
+
+    int32_t threshold() const {
+        return FIXED_THRESHOLD > 0 ? FIXED_THRESHOLD : runtime_threshold;
+    }
+
+    int32_t unstable(int32_t grains) const {
+        return grains >= threshold() ? 1 : 0;
+    }
+
+    // Times a cell topples in one multi-grain pass.
+    int32_t topples(int32_t grains) const {
+        return grains >= threshold() ? grains / threshold() : 0;
+    }
+
+    bool step(const HaloGrid<int32_t> &halo, int32_t *dst, int width, int height) const {
+        const int32_t t = threshold();
+        int32_t toppled = 0;
+        for (int y = 0; y < height; y++) {
+            const int32_t *up = halo.row(y - 1);
+            const int32_t *mid = halo.row(y);
+            const int32_t *down = halo.row(y + 1);
+            int32_t *out = dst + static_cast<int64_t>(y) * width;
+            for (int x = 0; x < width; x++) {
+                const int32_t self = unstable(mid[x]);
+                int32_t in = unstable(mid[x - 1]) + unstable(mid[x + 1]) + unstable(up[x]) + unstable(down[x]);
+                if (NEIGHBORS == 8) {
+                    in += unstable(up[x - 1]) + unstable(up[x + 1]) + unstable(down[x - 1]) + unstable(down[x + 1]);
+                }
+                out[x] = mid[x] - t * self + in;
+                toppled |= self;
+            }
+        }
+        return toppled != 0;
+    }
+
+    // One multi-grain pass from `front` into `back`; returns the topplings.
+    int64_t relax_pass(const HaloGrid<int32_t> &front, HaloGrid<int32_t> &back, int width, int height) const {
+        const int32_t t = threshold();
+        int64_t pass_topples = 0;
+        for (int y = 0; y < height; y++) {
+            const int32_t *up = front.row(y - 1);
+            const int32_t *mid = front.row(y);
+            const int32_t *down = front.row(y + 1);
+            int32_t *out = back.row(y);
+            int64_t row_topples = 0;
+            for (int x = 0; x < width; x++) {
+                const int32_t self = topples(mid[x]);
+                int32_t in = topples(mid[x - 1]) + topples(mid[x + 1]) + topples(up[x]) + topples(down[x]);
+                if (NEIGHBORS == 8) {
+                    in += topples(up[x - 1]) + topples(up[x + 1]) + topples(down[x - 1]) + topples(down[x + 1]);
+                }
+                out[x] = mid[x] - t * self + in;
+                row_topples += self;
+            }
+            pass_topples += row_topples;
+        }
+        return pass_topples;
+    }
+};
+
+// Calls fn(kernel) with the kernel instantiation for `rule`.
+template <typename Fn>
+auto with_sand_kernel(const SandRule &rule, Fn &&fn) {
+    if (rule.neighborhood == SAND_MOORE) {
+        return rule.threshold == 8 ? fn(SandKernel<8, 8>{ 8 }) : fn(SandKernel<8, 0>{ rule.threshold });
+    }
+    return rule.threshold == 4 ? fn(SandKernel<4, 4>{ 4 }) : fn(SandKernel<4, 0>{ rule.threshold });
+}
+
+} // namespace
+
+bool step_sand_grid(const int32_t *src, int32_t *dst, int width, int height, int edge_mode, const SandRule &rule) {
+    // With the ghost ring refreshed by edge mode, the grain a neighbor would send across the edge
+    // is exactly what the mirrored, wrapped or empty ghost cell sends in, so every cell is the
+    // same gather: keep what does not topple and add one grain per unstable neighbor.
+    static thread_local HaloGrid<int32_t> halo;
+    halo.resize(width, height);
+    halo.load(src);
+    halo.refresh(edge_mode);
+
+    return with_sand_kernel(rule, [&](const auto &kernel) {
+        return kernel.step(halo, dst, width, height);
+    });
+}
+
+int64_t sand_topple_budget(const int32_t *cells, size_t count, int edge_mode, int64_t max_topples, const SandRule &rule) {
+    if (max_topples > 0 || !sand_keeps_grains(edge_mode, rule)) {
+        return max_topples;
+    }
+    int64_t grains = 0;
+    for (size_t i = 0; i < count; i++) {
+        grains += cells[i];
+    }
+    return sand_settling_guaranteed(grains, count, edge_mode, rule) ? max_topples : SAND_UNGUARANTEED_MAX_TOPPLES;
+}
+
+SandRelaxResult relax_sand_grid(int32_t *cells, int width, int height, int edge_mode, int64_t max_topples, const SandRule &rule) {
+    max_topples = sand_topple_budget(cells, static_cast<size_t>(width) * height, edge_mode, max_topples, rule);
+    static thread_local HaloGrid<int32_t> front;
+    static thread_local HaloGrid<int32_t> back;
+    front.resize(width, height);
+    back.resize(width, height);
+    front.load(cells);
+
+    SandRelaxResult result;
+    while (max_topples <= 0 || result.topples < max_topples) {
+        front.refresh(edge_mode);
+        const int64_t pass_topples = with_sand_kernel(rule, [&](const auto &kernel) {
+            return kernel.relax_pass(front, back, width, height);
+        });
+        if (pass_topples == 0) {
+            result.stable = true;
+            break;
+        }
+        result.topples += pass_topples;
+        result.passes++;
+        std::swap(front, back);
+    }
+
+    front.store(cells);
+    if (!result.stable) {
+        // The budget ran out; the last pass may still have left the pile stable.
+        result.stable = true;
+        for (int64_t i = 0, count = static_cast<int64_t>(width) * height; i < count; i++) {
+            if (cells[i] >= rule.threshold) {
+                result.stable = false;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace automata
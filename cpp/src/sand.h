@@ -0,0 +1,70 @@
+#pragma once
+
+#include "automata_common.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Abelian sandpile kernels on a dense int32 grid. A cell holding `threshold` or more grains
+// topples, losing `threshold` grains and sending one to each of its 4 (von Neumann) or 8 (Moore)
+// neighbors, like updateSandpile in sandpile/sandpile.pde; grains sent past the edge wrap around
+// (wrap), land back on the edge cell (bounce) or are lost (falloff). The classic pile is
+// threshold 4 with von Neumann neighbors, the Moore pile threshold 8.
+
+namespace automata {
+
+constexpr int SAND_VON_NEUMANN = 0;
+constexpr int SAND_MOORE = 1;
+
+struct SandRule {
+    int32_t threshold = 4;
+    int neighborhood = SAND_VON_NEUMANN;
+};
+
+inline int sand_neighbor_count(int neighborhood) {
+    return neighborhood == SAND_MOORE ? 8 : 4;
+}
+
+// A threshold below the neighbor count creates grains with every toppling, so such a pile may
+// never settle; the native steppers reject those rules.
+inline bool sand_rule_valid(const SandRule &rule) {
+    return (rule.neighborhood == SAND_VON_NEUMANN || rule.neighborhood == SAND_MOORE) && rule.threshold >= sand_neighbor_count(rule.neighborhood);
+}
+
+// Wrap and bounce piles whose threshold equals the neighbor count keep every grain. Falloff piles
+// drain and a larger threshold loses grains with every toppling, so those always settle.
+inline bool sand_keeps_grains(int edge_mode, const SandRule &rule) {
+    return (edge_mode == EDGE_WRAP || edge_mode == EDGE_BOUNCE) && rule.threshold == sand_neighbor_count(rule.neighborhood);
+}
+
+// Conservative chip-firing is only guaranteed to end with fewer grains than the grid has edges
+// (loops included), neighbors / 2 per cell; from there on some piles never settle, like an 8x8
+// wrap pile of 3s with one 4.
+inline bool sand_settling_guaranteed(int64_t grains, size_t cells, int edge_mode, const SandRule &rule) {
+    return !sand_keeps_grains(edge_mode, rule) || grains < sand_neighbor_count(rule.neighborhood) / 2 * static_cast<int64_t>(cells);
+}
+
+// Topplings a "no limit" relax (max_topples <= 0) stops after when settling is not guaranteed.
+constexpr int64_t SAND_UNGUARANTEED_MAX_TOPPLES = int64_t(1) << 24;
+
+// The budget to relax `cells` with: `max_topples`, except that "no limit" becomes
+// SAND_UNGUARANTEED_MAX_TOPPLES on a pile that may never settle. Sums the grid only then.
+int64_t sand_topple_budget(const int32_t *cells, size_t count, int edge_mode, int64_t max_topples, const SandRule &rule);
+
+// One synchronous toppling pass: every unstable cell of `src` topples once into `dst`.
+// `src` and `dst` may not alias. Returns true when any cell toppled.
+bool step_sand_grid(const int32_t *src, int32_t *dst, int width, int height, int edge_mode, const SandRule &rule = SandRule());
+
+struct SandRelaxResult {
+    int64_t topples = 0; // Single-cell topplings performed (a cell holding k thresholds counts k).
+    int passes = 0;
+    bool stable = false;
+};
+
+// Topples `cells` in place until no cell is unstable, or until a pass brings the topple count to
+// `max_topples` (<= 0 means no limit, see sand_topple_budget). Each pass topples every unstable cell grains / threshold
+// times at once, like updateSandpile in sandpile/sandpile.pde; by the abelian property the
+// stable result matches toppling one grain-set at a time.
+SandRelaxResult relax_sand_grid(int32_t *cells, int width, int height, int edge_mode, int64_t max_topples, const SandRule &rule = SandRule());
+
+} // namespace automata
@@ -0,0 +1,61 @@
+#include "sand_cells.h"
+
+namespace automata {
+
+void SandCells::resize(size_t count) {
+    bytes.assign(count, 0);
+    overflow.clear();
+}
+
+void SandCells::load(const int32_t *src) {
+    overflow.clear();
+    for (size_t i = 0, count = bytes.size(); i < count; i++) {
+        const int32_t value = src[i];
+        if (value < SPILL) {
+            // Negative counts never occur in a pile; clamp rather than wrap if a script wrote one.
+            bytes[i] = static_cast<uint8_t>(value > 0 ? value : 0);
+        } else {
+            bytes[i] = SPILL;
+            overflow[static_cast<uint32_t>(i)] = value;
+        }
+    }
+}
+
+void SandCells::store(int32_t *dst) const {
+    for (size_t i = 0, count = bytes.size(); i < count; i++) {
+        dst[i] = bytes[i];
+    }
+    for (const auto &entry : overflow) {
+        dst[entry.first] = entry.second;
+    }
+}
+
+int32_t SandCells::spilled(size_t index) const {
+    return overflow.find(static_cast<uint32_t>(index))->second;
+}
+
+void SandCells::set_slow(size_t index, int32_t value) {
+    const uint32_t key = static_cast<uint32_t>(index);
+    if (value < SPILL) {
+        overflow.erase(key);
+        bytes[index] = static_cast<uint8_t>(value);
+        return;
+    }
+    bytes[index] = SPILL;
+    overflow[key] = value;
+}
+
+int32_t SandCells::add_slow(size_t index, int32_t amount) {
+    const uint32_t key = static_cast<uint32_t>(index);
+    if (bytes[index] != SPILL) {
+        const int32_t value = bytes[index] + amount;
+        bytes[index] = SPILL;
+        overflow[key] = value;
+        return value;
+    }
+    int32_t &value = overflow[key];
+    value += amount;
+    return value;
+}
+
+} // namespace automata
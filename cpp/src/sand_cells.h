@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Grain counts stored as one byte per cell, with a sparse spill map for the rare large cells.
+//
+// A relaxed pile holds 0..threshold-1 grains almost everywhere, so bytes carry the whole grid at
+// a quarter of the int32 traffic. A cell whose count reaches SPILL (only the drop site and its
+// surroundings during a large drop) keeps the byte SPILL as a marker and its real count in
+// `overflow`, and moves back into its byte once the count falls below SPILL again.
+
+namespace automata {
+
+class SandCells {
+public:
+    static constexpr uint8_t SPILL = 255;
+
+    // Resets to `count` empty cells.
+    void resize(size_t count);
+    size_t size() const { return bytes.size(); }
+
+    // Converts from / to int32 counts (`size()` values).
+    void load(const int32_t *src);
+    void store(int32_t *dst) const;
+
+    int32_t get(size_t index) const {
+        const uint8_t byte = bytes[index];
+        return byte != SPILL ? byte : spilled(index);
+    }
+
+    void set(size_t index, int32_t value) {
+        if (value < SPILL && bytes[index] != SPILL) {
+            bytes[index] = static_cast<uint8_t>(value);
+            return;
+        }
+        set_slow(index, value);
+    }
+
+    // Adds `amount` (>= 0) grains and returns the new count.
+    int32_t add(size_t index, int32_t amount) {
+        const int32_t value = bytes[index] + amount;
+        // A spilled byte already reads SPILL, so any result below SPILL comes from a byte cell.
+        if (value < SPILL) {
+            bytes[index] = static_cast<uint8_t>(value);
+            return value;
+        }
+        return add_slow(index, amount);
+    }
+
+    size_t get_spilled_count() const { return overflow.size(); }
+
+private:
+    int32_t spilled(size_t index) const;
+    void set_slow(size_t index, int32_t value);
+    int32_t add_slow(size_t index, int32_t amount);
+
+    std::vector<uint8_t> bytes;
+    std::unordered_map<uint32_t, int32_t> overflow;
+};
+
+} // namespace automata
@@ -0,0 +1,88 @@
+#include "sand_levels.h"
+
+#include "simd_target.h"
+#include "totalistic_simd.h"
+
+#include <algorithm>
+
+namespace automata {
+
+namespace {
+
+uint8_t encode_cell(int32_t grains, uint8_t palette) {
+    return grains > 0 ? static_cast<uint8_t>(std::min<int32_t>(grains, palette)) : 0;
+}
+
+bool encode_scalar(const int32_t *src, uint8_t *dst, size_t count, uint8_t palette) {
+    uint8_t any = 0;
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = encode_cell(src[i], palette);
+        any |= dst[i];
+    }
+    return any != 0;
+}
+
+#ifdef AUTOMATA_X86
+
+// Signed saturation to int16 and then unsigned saturation to uint8 maps every count <= 0 to 0
+// and every count >= 255 to 255, after which one unsigned min applies the palette. Palette
+// entries are at least 1, so a non-zero byte means the cell holds grains.
+
+AUTOMATA_TARGET("sse2")
+size_t encode_sse2(const int32_t *src, uint8_t *dst, size_t count, uint8_t palette, uint8_t &any) {
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(palette));
+    __m128i bits = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i *in = reinterpret_cast<const __m128i *>(src + i);
+        const __m128i lo = _mm_packs_epi32(_mm_loadu_si128(in), _mm_loadu_si128(in + 1));
+        const __m128i hi = _mm_packs_epi32(_mm_loadu_si128(in + 2), _mm_loadu_si128(in + 3));
+        const __m128i levels = _mm_min_epu8(_mm_packus_epi16(lo, hi), limit);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), levels);
+        bits = _mm_or_si128(bits, levels);
+    }
+    any |= _mm_movemask_epi8(_mm_cmpeq_epi8(bits, _mm_setzero_si128())) != 0xFFFF;
+    return i;
+}
+
+AUTOMATA_TARGET("avx2")
+size_t encode_avx2(const int32_t *src, uint8_t *dst, size_t count, uint8_t palette, uint8_t &any) {
+    const __m256i limit = _mm256_set1_epi8(static_cast<char>(palette));
+    // The 256-bit packs work per 128-bit lane; this restores cell order afterwards.
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    __m256i bits = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i *in = reinterpret_cast<const __m256i *>(src + i);
+        const __m256i lo = _mm256_packs_epi32(_mm256_loadu_si256(in), _mm256_loadu_si256(in + 1));
+        const __m256i hi = _mm256_packs_epi32(_mm256_loadu_si256(in + 2), _mm256_loadu_si256(in + 3));
+        const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), order);
+        const __m256i levels = _mm256_min_epu8(packed, limit);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), levels);
+        bits = _mm256_or_si256(bits, levels);
+    }
+    any |= !_mm256_testz_si256(bits, bits);
+    return i;
+}
+
+#endif // AUTOMATA_X86
+
+} // namespace
+
+bool encode_sand_levels(const int32_t *src, uint8_t *dst, size_t count, int palette_size) {
+    const uint8_t palette = static_cast<uint8_t>(std::clamp(palette_size, 1, 255));
+    uint8_t any = 0;
+    size_t done = 0;
+#ifdef AUTOMATA_X86
+    const SimdLevel level = active_simd_level();
+    if (level >= SIMD_AVX2) {
+        done = encode_avx2(src, dst, count, palette, any);
+    } else if (level >= SIMD_SSE2) {
+        done = encode_sse2(src, dst, count, palette, any);
+    }
+#endif
+    const bool tail = encode_scalar(src + done, dst + done, count - done, palette);
+    return any != 0 || tail;
+}
+
+} // namespace automata
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Sand grid to texture encoding: each cell becomes the palette index the sand shader samples,
+// 0 for empty cells and min(grains, palette_size) otherwise, as build_sand_image_from_data in
+// scripts/main.gd does.
+
+namespace automata {
+
+// Encodes `count` cells of `src` into `dst` (one byte each). `palette_size` is clamped to
+// 1..255. Returns true when any cell holds grains. Uses SSE2 or AVX2 when active.
+bool encode_sand_levels(const int32_t *src, uint8_t *dst, size_t count, int palette_size);
+
+} // namespace automata
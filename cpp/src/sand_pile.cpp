@@ -0,0 +1,304 @@
+#include "sand_pile.h"
+
+#include "automata_common.h"
+#include "sand_tiles.h"
+
+#include <algorithm>
+
+namespace automata {
+
+namespace {
+
+constexpr int DX[8] = { 0, 1, 0, -1, -1, 1, 1, -1 };
+constexpr int DY[8] = { -1, 0, 1, 0, -1, -1, 1, 1 };
+
+} // namespace
+
+template <int NEIGHBORS, typename Fn>
+void SandPile::for_each_target(int32_t index, Fn &&fn) const {
+    if (!border[index]) {
+        fn(index - width);
+        fn(index + 1);
+        fn(index + width);
+        fn(index - 1);
+        if (NEIGHBORS == 8) {
+            fn(index - width - 1);
+            fn(index - width + 1);
+            fn(index + width + 1);
+            fn(index + width - 1);
+        }
+        return;
+    }
+    for_each_border_target<NEIGHBORS>(index, fn);
+}
+
+// Border cells resolve each neighbor through the edge mode, as step_sand_grid does.
+template <int NEIGHBORS, typename Fn>
+void SandPile::for_each_border_target(int32_t index, Fn &fn) const {
+    const int x = index % width;
+    const int y = index / width;
+    for (int d = 0; d < NEIGHBORS; d++) {
+        int nx = x + DX[d];
+        int ny = y + DY[d];
+        if (nx < 0 || nx >= width || ny < 0 || ny >= height) {
+            switch (edge_mode) {
+                case EDGE_WRAP:
+                    nx = wrap_axis(nx, width);
+                    ny = wrap_axis(ny, height);
+                    break;
+                case EDGE_BOUNCE:
+                    nx = clamp_axis(nx, width);
+                    ny = clamp_axis(ny, height);
+                    break;
+                default:
+                    continue;
+            }
+        }
+        fn(ny * width + nx);
+    }
+}
+
+void SandPile::resize(int p_width, int p_height) {
+    width = p_width;
+    height = p_height;
+    const size_t count = static_cast<size_t>(width) * height;
+    cells.resize(count);
+    queued.assign(count, 0);
+    border.assign(count, 0);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            border[static_cast<size_t>(y) * width + x] = x == 0 || y == 0 || x == width - 1 || y == height - 1;
+        }
+    }
+    pending.clear();
+    wave.clear();
+    round_left = 0;
+    if (recording) {
+        // Same-size resets (NativeSandpile.clear) keep the collected statistics.
+        if (stats.get_cell_topples().size() != count) {
+            stats.resize(count);
+        } else {
+            stats.finish();
+        }
+    }
+}
+
+void SandPile::set_recording(bool enabled) {
+    if (enabled == recording) {
+        return;
+    }
+    recording = enabled;
+    round_left = 0;
+    stats = SandAvalancheStats();
+    if (enabled) {
+        stats.resize(cells.size());
+    }
+}
+
+void SandPile::set_rule(const SandRule &p_rule) {
+    const bool changed = p_rule.threshold != rule.threshold || p_rule.neighborhood != rule.neighborhood;
+    rule = p_rule;
+    if (changed) {
+        rebuild_worklist();
+    }
+}
+
+void SandPile::load(const int32_t *src) {
+    cells.load(src);
+    rebuild_worklist();
+}
+
+void SandPile::rebuild_worklist() {
+    const size_t count = cells.size();
+    std::fill(queued.begin(), queued.end(), 0);
+    pending.clear();
+    for (size_t i = 0; i < count; i++) {
+        if (cells.get(i) >= rule.threshold) {
+            enqueue(static_cast<int32_t>(i));
+        }
+    }
+    round_left = 0;
+    if (recording && pending.empty()) {
+        stats.finish();
+    }
+}
+
+void SandPile::store(int32_t *dst) const {
+    cells.store(dst);
+}
+
+void SandPile::add(int x, int y, int32_t amount) {
+    const int32_t index = y * width + x;
+    if (cells.add(index, amount) >= rule.threshold) {
+        enqueue(index);
+    }
+}
+
+bool SandPile::step() {
+    if (pending.empty()) {
+        return false;
+    }
+    if (recording) {
+        return rule.neighborhood == SAND_MOORE ? step_wave<8, true>() : step_wave<4, true>();
+    }
+    return rule.neighborhood == SAND_MOORE ? step_wave<8, false>() : step_wave<4, false>();
+}
+
+template <int NEIGHBORS, bool RECORD>
+bool SandPile::step_wave() {
+    // Every cell in the wave was unstable at the start, so the topples can be applied in place.
+    const int32_t threshold = rule.threshold;
+    wave.swap(pending);
+    for (int32_t index : wave) {
+        queued[index] = 0;
+    }
+    for (int32_t index : wave) {
+        cells.set(index, cells.get(index) - threshold);
+        for_each_target<NEIGHBORS>(index, [&](int32_t target) {
+            cells.add(target, 1);
+        });
+        if (RECORD) {
+            stats.add_topples(index, 1);
+        }
+    }
+    for (int32_t index : wave) {
+        if (cells.get(index) >= threshold) {
+            enqueue(index);
+        }
+        for_each_target<NEIGHBORS>(index, [&](int32_t target) {
+            if (cells.get(target) >= threshold) {
+                enqueue(target);
+            }
+        });
+    }
+    wave.clear();
+    if (RECORD) {
+        round_left = 0;
+        stats.add_duration(1);
+        if (pending.empty()) {
+            stats.finish();
+        }
+    }
+    return true;
+}
+
+SandRelaxResult SandPile::relax(int64_t max_topples) {
+    if (pending.empty()) {
+        SandRelaxResult result;
+        result.stable = true;
+        return result;
+    }
+    if (max_topples <= 0 && sand_keeps_grains(edge_mode, rule)) {
+        int64_t grains = 0;
+        for (size_t i = 0; i < cells.size(); i++) {
+            grains += cells.get(i);
+        }
+        if (!sand_settling_guaranteed(grains, cells.size(), edge_mode, rule)) {
+            max_topples = SAND_UNGUARANTEED_MAX_TOPPLES;
+        }
+    }
+    if (rule.neighborhood == SAND_MOORE) {
+        return recording ? relax_rule<8, true>(max_topples) : relax_rule<8, false>(max_topples);
+    }
+    return recording ? relax_rule<4, true>(max_topples) : relax_rule<4, false>(max_topples);
+}
+
+// The classic piles divide by a constant threshold.
+template <int NEIGHBORS, bool RECORD>
+SandRelaxResult SandPile::relax_rule(int64_t max_topples) {
+    return rule.threshold == NEIGHBORS ? relax_worklist<NEIGHBORS, NEIGHBORS, RECORD>(max_topples) : relax_worklist<NEIGHBORS, 0, RECORD>(max_topples);
+}
+
+template <int NEIGHBORS, int32_t FIXED_THRESHOLD, bool RECORD>
+SandRelaxResult SandPile::relax_worklist(int64_t max_topples) {
+    SandRelaxResult result;
+    const int32_t threshold = FIXED_THRESHOLD > 0 ? FIXED_THRESHOLD : rule.threshold;
+
+    // First in, first out: a queued cell keeps collecting grains until its turn, so each visit
+    // topples a larger batch. A cell is queued at most once, so one slot per cell plus one per
+    // neighbor write is enough for pushes to be written unconditionally and kept or dropped
+    // without a branch.
+    const size_t capacity = cells.size() + NEIGHBORS;
+    ring.resize(capacity);
+    std::copy(pending.begin(), pending.end(), ring.begin());
+    size_t head = 0;
+    size_t count = pending.size();
+    size_t tail = count;
+
+    uint8_t *in_queue = queued.data();
+    int32_t *slots = ring.data();
+    int64_t topples_total = 0;
+    // Rounds: the cells queued at the start, then everything they queued, and so on.
+    size_t round = RECORD && round_left > 0 && round_left <= count ? round_left : count;
+    while (count > 0 && (max_topples <= 0 || topples_total < max_topples)) {
+        const int32_t index = slots[head];
+        head = head + 1 == capacity ? 0 : head + 1;
+        count--;
+        in_queue[index] = 0;
+
+        const int32_t grains = cells.get(index);
+        const int32_t topples = grains / threshold;
+        cells.set(index, grains - topples * threshold);
+        topples_total += topples;
+        for_each_target<NEIGHBORS>(index, [&](int32_t target) {
+            const int32_t received = cells.add(target, topples);
+            const uint8_t push = static_cast<uint8_t>((received >= threshold) & (in_queue[target] ^ 1));
+            in_queue[target] |= push;
+            slots[tail] = target;
+            tail += push;
+            tail = tail == capacity ? 0 : tail;
+            count += push;
+        });
+        if (RECORD) {
+            stats.add_topples(index, topples);
+            if (--round == 0) {
+                stats.add_duration(1);
+                round = count;
+            }
+        }
+    }
+
+    pending.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        pending[i] = slots[(head + i) % capacity];
+    }
+    if (RECORD) {
+        round_left = round;
+        if (count == 0) {
+            stats.finish();
+        }
+    }
+    result.topples = topples_total;
+    result.stable = count == 0;
+    return result;
+}
+
+SandRelaxResult SandPile::relax_parallel(int64_t max_topples, WorkerPool &pool) {
+    if (recording) {
+        // Tiles topple in no reproducible order, so avalanches are only measured serially.
+        return relax(max_topples);
+    }
+    SandRelaxResult result;
+    if (pending.empty()) {
+        result.stable = true;
+        return result;
+    }
+
+    // The tile relaxer works on int32 cells (and applies sand_topple_budget to them); the round trip costs two passes over the grid, small
+    // next to an avalanche large enough to go parallel.
+    scratch.resize(cells.size());
+    cells.store(scratch.data());
+    result = relax_sand_tiles(scratch.data(), width, height, edge_mode, max_topples, pool, rule, pending.data(), pending.size());
+    cells.load(scratch.data());
+    if (result.stable) {
+        for (int32_t index : pending) {
+            queued[index] = 0;
+        }
+        pending.clear();
+    } else {
+        rebuild_worklist();
+    }
+    return result;
+}
+
+} // namespace automata
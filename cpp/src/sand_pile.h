@@ -0,0 +1,108 @@
+#pragma once
+
+#include "sand.h"
+#include "sand_cells.h"
+#include "sand_stats.h"
+#include "worker_pool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Persistent sandpile with a worklist of unstable cells.
+//
+// Every unstable cell is in the worklist exactly once (a flag per cell keeps it
+// deduplicated), and toppling feeds neighbors back in as they cross the threshold. Work per call
+// therefore scales with the avalanche rather than the grid area, and a stable pile costs one
+// emptiness check. Edge modes and rules match step_sand_grid. Cells are bytes with a spill map
+// (see sand_cells.h), so stepping a relaxed pile moves a quarter of the int32 memory.
+
+namespace automata {
+
+class SandPile {
+public:
+    // Resets to an empty width x height pile.
+    void resize(int width, int height);
+    void set_edge_mode(int mode) { edge_mode = mode; }
+    int get_edge_mode() const { return edge_mode; }
+    // Changes the threshold and neighborhood (see sand.h); the worklist is rebuilt when they differ.
+    void set_rule(const SandRule &rule);
+    const SandRule &get_rule() const { return rule; }
+    int get_width() const { return width; }
+    int get_height() const { return height; }
+
+    // Replaces every cell (width * height values) and rebuilds the worklist with one scan.
+    void load(const int32_t *src);
+    void store(int32_t *dst) const;
+
+    int32_t get(int x, int y) const { return cells.get(static_cast<size_t>(y) * width + x); }
+    void add(int x, int y, int32_t amount);
+
+    // One synchronous wave: every cell unstable at the start topples once, like step_sand_grid.
+    // Returns true when anything toppled.
+    bool step();
+
+    // Topples cells grains / threshold times at once in worklist order until the pile is stable
+    // or at least `max_topples` single-cell topplings were done (<= 0 means no limit, capped as in
+    // sand_topple_budget). The stable pile is the same as repeated step() calls give.
+    SandRelaxResult relax(int64_t max_topples);
+    // Same result through relax_sand_tiles on `pool`; worth it once avalanches span many tiles.
+    // The budget is checked between tile phases, and an unfinished pile rescans its worklist.
+    SandRelaxResult relax_parallel(int64_t max_topples, WorkerPool &pool);
+
+    bool is_stable() const { return pending.empty(); }
+    size_t get_unstable_count() const { return pending.size(); }
+    // Cells holding SandCells::SPILL or more grains.
+    size_t get_spilled_count() const { return cells.get_spilled_count(); }
+
+    // Avalanche recording (see sand_stats.h). step() and relax() pick instantiations with or
+    // without it, so a pile that does not record runs exactly the uninstrumented loops. While
+    // recording, relax_parallel() relaxes serially. Disabling frees the per-cell tables.
+    void set_recording(bool enabled);
+    bool is_recording() const { return recording; }
+    const SandAvalancheStats &get_stats() const { return stats; }
+    void reset_stats() { stats.reset(); }
+
+private:
+    void rebuild_worklist();
+    void enqueue(int32_t index) {
+        if (!queued[index]) {
+            queued[index] = 1;
+            pending.push_back(index);
+        }
+    }
+
+    // Calls fn(neighbor_index) for each of the NEIGHBORS neighbors that receive a grain from `index`.
+    template <int NEIGHBORS, typename Fn>
+    void for_each_target(int32_t index, Fn &&fn) const;
+    template <int NEIGHBORS, typename Fn>
+    void for_each_border_target(int32_t index, Fn &fn) const;
+
+    template <int NEIGHBORS, bool RECORD>
+    bool step_wave();
+    template <int NEIGHBORS, bool RECORD>
+    SandRelaxResult relax_rule(int64_t max_topples);
+    // FIXED_THRESHOLD 0 reads rule.threshold.
+    template <int NEIGHBORS, int32_t FIXED_THRESHOLD, bool RECORD>
+    SandRelaxResult relax_worklist(int64_t max_topples);
+
+    SandCells cells;
+    std::vector<uint8_t> queued;
+    // 1 for cells on the outer ring, whose neighbors go through the edge mode.
+    std::vector<uint8_t> border;
+    std::vector<int32_t> pending;
+    std::vector<int32_t> wave;
+    std::vector<int32_t> ring;
+    // int32 copy of the cells for relax_parallel.
+    std::vector<int32_t> scratch;
+    int width = 0;
+    int height = 0;
+    int edge_mode = 0;
+    SandRule rule;
+    SandAvalancheStats stats;
+    bool recording = false;
+    // Cells of the current relax() round still queued, kept across budgeted calls while recording.
+    size_t round_left = 0;
+};
+
+} // namespace automata
@@ -0,0 +1,58 @@
+#include "sand_stats.h"
+
+#include <algorithm>
+
+namespace automata {
+
+namespace {
+
+int histogram_bin(int64_t value) {
+    int bin = 0;
+    for (uint64_t rest = static_cast<uint64_t>(std::max<int64_t>(value, 0)); rest != 0; rest >>= 1) {
+        bin++;
+    }
+    return std::min(bin, SandAvalancheStats::BINS - 1);
+}
+
+} // namespace
+
+void SandAvalancheStats::resize(size_t cell_count) {
+    cell_topples.assign(cell_count, 0);
+    cell_epoch.assign(cell_count, 0);
+    epoch = 1;
+    current = SandAvalanche();
+    reset();
+}
+
+void SandAvalancheStats::reset() {
+    last = SandAvalanche();
+    largest = SandAvalanche();
+    avalanches = 0;
+    size_histogram.fill(0);
+    area_histogram.fill(0);
+    duration_histogram.fill(0);
+    std::fill(cell_topples.begin(), cell_topples.end(), 0);
+}
+
+void SandAvalancheStats::finish() {
+    if (current.topples == 0) {
+        current = SandAvalanche();
+        return;
+    }
+    size_histogram[histogram_bin(current.topples)]++;
+    area_histogram[histogram_bin(current.area)]++;
+    duration_histogram[histogram_bin(current.duration)]++;
+    avalanches++;
+    last = current;
+    if (current.topples > largest.topples) {
+        largest = current;
+    }
+    current = SandAvalanche();
+    if (++epoch == 0) {
+        // Wrapped after 2^32 avalanches: old marks could alias the new numbers.
+        std::fill(cell_epoch.begin(), cell_epoch.end(), 0);
+        epoch = 1;
+    }
+}
+
+} // namespace automata
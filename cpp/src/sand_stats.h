@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Avalanche statistics for SandPile.
+//
+// An avalanche runs from the first topple after the pile was stable until it is stable again, and
+// may span several step() or budgeted relax() calls. Each finished avalanche is binned by topple
+// count, area (distinct cells that toppled) and duration into log2 histograms, and every topple is
+// added to a per-cell total. All storage is allocated when recording is enabled, so recording a
+// topple never allocates. The pile only calls into this class from instantiations compiled with
+// recording on; the default ones contain none of it.
+
+namespace automata {
+
+struct SandAvalanche {
+    int64_t topples = 0;
+    int64_t area = 0;
+    // Waves for step(); worklist rounds (cells queued by the previous round) for relax().
+    int64_t duration = 0;
+};
+
+class SandAvalancheStats {
+public:
+    // Bin 0 counts zero, bin k >= 1 counts values in [2^(k-1), 2^k).
+    static constexpr int BINS = 64;
+    using Histogram = std::array<int64_t, BINS>;
+
+    // Allocates the per-cell tables for `cell_count` cells and clears everything.
+    void resize(size_t cell_count);
+    // Clears histograms and per-cell totals; an avalanche in progress keeps counting.
+    void reset();
+
+    void add_topples(int32_t index, int64_t count) {
+        current.topples += count;
+        cell_topples[index] += count;
+        if (cell_epoch[index] != epoch) {
+            cell_epoch[index] = epoch;
+            current.area++;
+        }
+    }
+    void add_duration(int64_t steps) { current.duration += steps; }
+    // Bins the avalanche in progress, if anything toppled, and starts the next one.
+    void finish();
+
+    bool is_running() const { return current.topples > 0; }
+    int64_t get_avalanche_count() const { return avalanches; }
+    const SandAvalanche &get_last() const { return last; }
+    const SandAvalanche &get_largest() const { return largest; }
+    const Histogram &get_size_histogram() const { return size_histogram; }
+    const Histogram &get_area_histogram() const { return area_histogram; }
+    const Histogram &get_duration_histogram() const { return duration_histogram; }
+    const std::vector<int64_t> &get_cell_topples() const { return cell_topples; }
+
+private:
+    SandAvalanche current;
+    SandAvalanche last;
+    SandAvalanche largest;
+    int64_t avalanches = 0;
+    Histogram size_histogram{};
+    Histogram area_histogram{};
+    Histogram duration_histogram{};
+    std::vector<int64_t> cell_topples;
+    // Avalanche number that last counted each cell toward its area.
+    std::vector<uint32_t> cell_epoch;
+    uint32_t epoch = 1;
+};
+
+} // namespace automata
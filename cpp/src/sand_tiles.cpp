@@ -0,0 +1,318 @@
+#include "sand_tiles.h"
+
+#include "automata_common.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace automata {
+
+namespace {
+
+static_assert(SAND_TILE * SAND_TILE <= 65536, "local queue entries are 16-bit tile indices");
+
+// Tile boundaries along one axis: `count` tiles, tile i covering [starts[i], starts[i + 1]).
+struct AxisTiles {
+    int count = 0;
+    std::vector<int> starts;
+    std::vector<int> tile_of; // Tile index for every coordinate.
+
+    void build(int size, bool wrap) {
+        count = (size + SAND_TILE - 1) / SAND_TILE;
+        // Wrapped ends touch, so an odd count would put two tiles of one color side by side.
+        if (wrap && count > 1 && (count & 1)) {
+            count++;
+        }
+        count = std::min(count, size);
+        starts.resize(count + 1);
+        for (int i = 0; i <= count; i++) {
+            starts[i] = static_cast<int>(static_cast<int64_t>(size) * i / count);
+        }
+        tile_of.resize(size);
+        for (int i = 0; i < count; i++) {
+            std::fill(tile_of.begin() + starts[i], tile_of.begin() + starts[i + 1], i);
+        }
+    }
+};
+
+struct TileGrid {
+    int32_t *cells;
+    int width;
+    int height;
+    int edge_mode;
+    int32_t threshold;
+    AxisTiles xs;
+    AxisTiles ys;
+    std::unique_ptr<std::atomic<uint8_t>[]> dirty;
+
+    int tile_count() const { return xs.count * ys.count; }
+};
+
+bool tile_has_unstable(const TileGrid &grid, int tx, int ty) {
+    for (int y = grid.ys.starts[ty]; y < grid.ys.starts[ty + 1]; y++) {
+        const int32_t *row = grid.cells + static_cast<int64_t>(y) * grid.width;
+        for (int x = grid.xs.starts[tx]; x < grid.xs.starts[tx + 1]; x++) {
+            if (row[x] >= grid.threshold) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+constexpr int DX[8] = { 0, 1, 0, -1, -1, 1, 1, -1 };
+constexpr int DY[8] = { -1, 0, 1, 0, -1, -1, 1, 1 };
+
+// Relaxes one tile to local stability, or until at least `max_topples` single-cell topplings were
+// done (<= 0 means no limit), and returns the topplings. A tile stopped early stays dirty.
+// FIXED_THRESHOLD 0 reads grid.threshold.
+template <int NEIGHBORS, int32_t FIXED_THRESHOLD>
+int64_t relax_tile(TileGrid &grid, int tx, int ty, int64_t max_topples) {
+    const int32_t threshold = FIXED_THRESHOLD > 0 ? FIXED_THRESHOLD : grid.threshold;
+    const int x0 = grid.xs.starts[tx];
+    const int y0 = grid.ys.starts[ty];
+    const int tw = grid.xs.starts[tx + 1] - x0;
+    const int th = grid.ys.starts[ty + 1] - y0;
+    const int width = grid.width;
+    const int height = grid.height;
+    int32_t *base = grid.cells + static_cast<int64_t>(y0) * width + x0;
+
+    // Entries are tile-local indices ly * tw + lx.
+    static thread_local std::vector<uint16_t> queue;
+    static thread_local std::vector<uint8_t> queued;
+    // One slot per cell plus one per neighbor write, as in SandPile::relax.
+    const size_t capacity = static_cast<size_t>(tw) * th + NEIGHBORS;
+    queue.resize(capacity);
+    queued.assign(static_cast<size_t>(tw) * th, 0);
+
+    size_t head = 0;
+    size_t tail = 0;
+    size_t count = 0;
+    for (int ly = 0; ly < th; ly++) {
+        const int32_t *row = base + static_cast<int64_t>(ly) * width;
+        for (int lx = 0; lx < tw; lx++) {
+            if (row[lx] >= threshold) {
+                queue[tail++] = static_cast<uint16_t>(ly * tw + lx);
+                queued[ly * tw + lx] = 1;
+                count++;
+            }
+        }
+    }
+
+    int64_t topples_total = 0;
+    uint16_t *slots = queue.data();
+    uint8_t *in_queue = queued.data();
+    // Adds grains to tile-local cell `li` (at `target`) and queues it once it becomes unstable.
+    auto feed = [&](int32_t *target, int li, int32_t amount) {
+        *target += amount;
+        const uint8_t push = static_cast<uint8_t>((*target >= threshold) & (in_queue[li] ^ 1));
+        in_queue[li] |= push;
+        slots[tail] = static_cast<uint16_t>(li);
+        tail += push;
+        tail = tail == capacity ? 0 : tail;
+        count += push;
+    };
+
+    while (count > 0 && (max_topples <= 0 || topples_total < max_topples)) {
+        const int li = slots[head];
+        head = head + 1 == capacity ? 0 : head + 1;
+        count--;
+        in_queue[li] = 0;
+
+        const int lx = li % tw;
+        const int ly = li / tw;
+        int32_t *cell = base + static_cast<int64_t>(ly) * width + lx;
+        const int32_t topples = *cell / threshold;
+        *cell -= topples * threshold;
+        topples_total += topples;
+
+        if (lx > 0 && lx < tw - 1 && ly > 0 && ly < th - 1) {
+            feed(cell - width, li - tw, topples);
+            feed(cell + 1, li + 1, topples);
+            feed(cell + width, li + tw, topples);
+            feed(cell - 1, li - 1, topples);
+            if (NEIGHBORS == 8) {
+                feed(cell - width - 1, li - tw - 1, topples);
+                feed(cell - width + 1, li - tw + 1, topples);
+                feed(cell + width + 1, li + tw + 1, topples);
+                feed(cell + width - 1, li + tw - 1, topples);
+            }
+            continue;
+        }
+
+        // Tile border: neighbors may lie in another tile, which is only marked dirty, or go
+        // through the edge mode.
+        const int x = x0 + lx;
+        const int y = y0 + ly;
+        for (int d = 0; d < NEIGHBORS; d++) {
+            int nx = x + DX[d];
+            int ny = y + DY[d];
+            if (nx < 0 || nx >= width || ny < 0 || ny >= height) {
+                switch (grid.edge_mode) {
+                    case EDGE_WRAP:
+                        nx = wrap_axis(nx, width);
+                        ny = wrap_axis(ny, height);
+                        break;
+                    case EDGE_BOUNCE:
+                        nx = clamp_axis(nx, width);
+                        ny = clamp_axis(ny, height);
+                        break;
+                    default:
+                        continue;
+                }
+            }
+            int32_t *target = grid.cells + static_cast<int64_t>(ny) * width + nx;
+            const int nlx = nx - x0;
+            const int nly = ny - y0;
+            if (nlx >= 0 && nlx < tw && nly >= 0 && nly < th) {
+                feed(target, nly * tw + nlx, topples);
+            } else {
+                *target += topples;
+                if (*target >= threshold) {
+                    grid.dirty[grid.ys.tile_of[ny] * grid.xs.count + grid.xs.tile_of[nx]].store(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+    if (count > 0) {
+        grid.dirty[ty * grid.xs.count + tx].store(1, std::memory_order_relaxed);
+    }
+    return topples_total;
+}
+
+using TileRelax = int64_t (*)(TileGrid &, int, int, int64_t);
+
+// The classic piles divide by a constant threshold.
+TileRelax select_tile_relax(const SandRule &rule) {
+    if (rule.neighborhood == SAND_MOORE) {
+        return rule.threshold == 8 ? &relax_tile<8, 8> : &relax_tile<8, 0>;
+    }
+    return rule.threshold == 4 ? &relax_tile<4, 4> : &relax_tile<4, 0>;
+}
+
+} // namespace
+
+SandRelaxResult relax_sand_tiles(int32_t *cells, int width, int height, int edge_mode, int64_t max_topples, WorkerPool &pool,
+        const SandRule &rule, const int32_t *seeds, size_t seed_count) {
+    max_topples = sand_topple_budget(cells, static_cast<size_t>(width) * height, edge_mode, max_topples, rule);
+    TileGrid grid;
+    grid.cells = cells;
+    grid.width = width;
+    grid.height = height;
+    grid.edge_mode = edge_mode;
+    grid.threshold = rule.threshold;
+    const TileRelax relax_tile = select_tile_relax(rule);
+    grid.xs.build(width, edge_mode == EDGE_WRAP);
+    grid.ys.build(height, edge_mode == EDGE_WRAP);
+    const int tiles = grid.tile_count();
+    grid.dirty = std::make_unique<std::atomic<uint8_t>[]>(tiles);
+
+    if (seeds) {
+        for (size_t i = 0; i < seed_count; i++) {
+            const int x = seeds[i] % width;
+            const int y = seeds[i] / width;
+            grid.dirty[grid.ys.tile_of[y] * grid.xs.count + grid.xs.tile_of[x]].store(1, std::memory_order_relaxed);
+        }
+    } else {
+        pool.run(static_cast<uint32_t>(tiles), [&](uint32_t t) {
+            const int tx = static_cast<int>(t) % grid.xs.count;
+            const int ty = static_cast<int>(t) / grid.xs.count;
+            grid.dirty[t].store(tile_has_unstable(grid, tx, ty) ? 1 : 0, std::memory_order_relaxed);
+        });
+    }
+
+    SandRelaxResult result;
+    std::vector<int> batch;
+    std::vector<int64_t> batch_topples;
+    bool any_dirty = true;
+    while (any_dirty && (max_topples <= 0 || result.topples < max_topples)) {
+        any_dirty = false;
+        for (int phase = 0; phase < 4; phase++) {
+            batch.clear();
+            for (int ty = phase >> 1; ty < grid.ys.count; ty += 2) {
+                for (int tx = phase & 1; tx < grid.xs.count; tx += 2) {
+                    const int t = ty * grid.xs.count + tx;
+                    if (grid.dirty[t].load(std::memory_order_relaxed)) {
+                        grid.dirty[t].store(0, std::memory_order_relaxed);
+                        batch.push_back(t);
+                    }
+                }
+            }
+            if (batch.empty()) {
+                continue;
+            }
+            any_dirty = true;
+            batch_topples.assign(batch.size(), 0);
+            // pool.run returns after every job finished, which orders this phase's writes
+            // before the next phase reads them. Each tile gets the whole remaining budget, so a
+            // call may overshoot it by up to one tile's worth of topplings per thread.
+            const int64_t remaining = max_topples > 0 ? max_topples - result.topples : 0;
+            pool.run(static_cast<uint32_t>(batch.size()), [&](uint32_t i) {
+                batch_topples[i] = relax_tile(grid, batch[i] % grid.xs.count, batch[i] / grid.xs.count, remaining);
+            });
+            for (int64_t topples : batch_topples) {
+                result.topples += topples;
+            }
+            if (max_topples > 0 && result.topples >= max_topples) {
+                break;
+            }
+        }
+        if (any_dirty) {
+            result.passes++;
+        }
+    }
+
+    result.stable = true;
+    for (int t = 0; t < tiles; t++) {
+        if (grid.dirty[t].load(std::memory_order_relaxed)) {
+            result.stable = false;
+            break;
+        }
+    }
+    return result;
+}
+
+SandRelaxResult drop_sand_stabilized(int32_t *cells, int width, int height, int edge_mode, int x, int y, int64_t amount, WorkerPool &pool,
+        const SandRule &rule) {
+    SandRelaxResult result;
+    const size_t count = static_cast<size_t>(width) * height;
+    if (sand_keeps_grains(edge_mode, rule)) {
+        int64_t total = amount;
+        for (size_t i = 0; i < count; i++) {
+            total += cells[i];
+        }
+        if (!sand_settling_guaranteed(total, count, edge_mode, rule)) {
+            return result;
+        }
+    }
+
+    auto accumulate = [&result](const SandRelaxResult &stage) {
+        result.topples += stage.topples;
+        result.passes += stage.passes;
+    };
+
+    std::vector<int32_t> pile(count, 0);
+    const size_t drop = static_cast<size_t>(y) * width + x;
+    int bit = 62;
+    while (bit > 0 && !((amount >> bit) & 1)) {
+        bit--;
+    }
+    for (; bit >= 0; bit--) {
+        for (int32_t &cell : pile) {
+            cell *= 2;
+        }
+        pile[drop] += static_cast<int32_t>((amount >> bit) & 1);
+        accumulate(relax_sand_tiles(pile.data(), width, height, edge_mode, 0, pool, rule));
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        cells[i] += pile[i];
+    }
+    accumulate(relax_sand_tiles(cells, width, height, edge_mode, 0, pool, rule));
+    result.stable = true;
+    return result;
+}
+
+} // namespace automata
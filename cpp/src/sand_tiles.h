@@ -0,0 +1,39 @@
+#pragma once
+
+#include "sand.h"
+#include "worker_pool.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Multithreaded sand relaxation over tiles in four color phases.
+//
+// The grid is cut into tiles of at most SAND_TILE x SAND_TILE cells, colored by the parity of
+// their tile coordinates. Within a phase every dirty tile of that color relaxes to local
+// stability on its own worklist; grains leaving the tile are added straight to the neighboring tile, which is of
+// another color and therefore idle, and mark it dirty. Tiles of one color never touch, not even
+// diagonally (wrap grids get an even tile count per axis), so no two threads share a cell. Phases
+// repeat until no tile is dirty; by the abelian property the stable pile equals the serial one.
+
+namespace automata {
+
+constexpr int SAND_TILE = 64;
+
+// Same contract as relax_sand_grid; the budget is checked between phases, and `passes` counts
+// rounds of the four phases. When `seeds` is given, only tiles holding one of its `seed_count`
+// cell indices start dirty, and it must list every unstable cell; otherwise the grid is scanned.
+SandRelaxResult relax_sand_tiles(int32_t *cells, int width, int height, int edge_mode, int64_t max_topples, WorkerPool &pool,
+        const SandRule &rule = SandRule(), const int32_t *seeds = nullptr, size_t seed_count = 0);
+
+// Adds `amount` grains at (x, y) and stabilizes, with exactly the result of dropping them one at
+// a time. The drop is built by abelian superposition in doubling stages on a scratch pile that
+// starts empty: each stage doubles the pile (2 * stab(m grains) is reachable from 2m grains by
+// legal topplings), adds the next bit of `amount` and relaxes; the finished pile is then added to
+// `cells` and relaxed once more. `topples` and `passes` sum over the stages. Wrap and bounce grids
+// keep every grain when the threshold equals the neighbor count, and their relaxation is then
+// only guaranteed to end below neighbors / 2 grains per cell, so a drop that would reach that
+// total returns unstable without changing `cells`.
+SandRelaxResult drop_sand_stabilized(int32_t *cells, int width, int height, int edge_mode, int x, int y, int64_t amount, WorkerPool &pool,
+        const SandRule &rule = SandRule());
+
+} // namespace automata
@@ -0,0 +1,16 @@
+#pragma once
+
+// Per-function ISA targeting shared by the vectorized kernels. Kernels are compiled with
+// AUTOMATA_TARGET("avx2") etc. and only called after the CPUID probe in totalistic_simd.cpp
+// reports that level, so the library itself still builds for the baseline ISA.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AUTOMATA_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(AUTOMATA_X86) && !defined(_MSC_VER)
+#define AUTOMATA_TARGET(isa) __attribute__((target(isa)))
+#else
+#define AUTOMATA_TARGET(isa)
+#endif
@@ -0,0 +1,317 @@
+#include "sparse_world.h"
+
+#include "automata_common.h"
+#include "totalistic_simd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace automata {
+
+namespace {
+
+constexpr int PADDED = SparseWorld::CHUNK + 2;
+
+constexpr int DIR_X[4] = { 0, 1, 0, -1 };
+constexpr int DIR_Y[4] = { -1, 0, 1, 0 };
+
+inline int64_t chunk_of(int64_t v) {
+    return v >> 6;
+}
+
+inline int cell_of(int64_t v) {
+    return static_cast<int>(v & (SparseWorld::CHUNK - 1));
+}
+
+int32_t count_cells(const uint8_t *cells) {
+    int32_t population = 0;
+    for (int i = 0; i < SparseWorld::CHUNK_CELLS; i++) {
+        population += cells[i] != 0;
+    }
+    return population;
+}
+
+bool row_any(const uint8_t *row, int stride, int count) {
+    for (int i = 0; i < count; i++) {
+        if (row[i * stride]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+static_assert(SparseWorld::CHUNK == 64, "chunk_of() shifts by log2(CHUNK)");
+
+void SparseWorld::clear() {
+    for (auto &entry : chunks) {
+        recycle(std::move(entry.second));
+    }
+    chunks.clear();
+}
+
+const SparseWorld::Chunk *SparseWorld::find(int64_t cx, int64_t cy) const {
+    const auto it = chunks.find(key(cx, cy));
+    return it == chunks.end() ? nullptr : it->second.get();
+}
+
+SparseWorld::Chunk *SparseWorld::find_or_create(int64_t cx, int64_t cy) {
+    std::unique_ptr<Chunk> &slot = chunks[key(cx, cy)];
+    if (!slot) {
+        slot = take_spare();
+    }
+    return slot.get();
+}
+
+std::unique_ptr<SparseWorld::Chunk> SparseWorld::take_spare() {
+    std::unique_ptr<Chunk> chunk;
+    if (spare.empty()) {
+        chunk = std::make_unique<Chunk>();
+    } else {
+        chunk = std::move(spare.back());
+        spare.pop_back();
+    }
+    memset(chunk->cells, 0, sizeof(chunk->cells));
+    chunk->population = 0;
+    return chunk;
+}
+
+void SparseWorld::recycle(std::unique_ptr<Chunk> chunk) {
+    if (spare.size() < MAX_SPARE) {
+        spare.push_back(std::move(chunk));
+    }
+}
+
+void SparseWorld::release(uint64_t k) {
+    const auto it = chunks.find(k);
+    if (it != chunks.end()) {
+        recycle(std::move(it->second));
+        chunks.erase(it);
+    }
+}
+
+uint8_t SparseWorld::get_cell(int64_t x, int64_t y) const {
+    const Chunk *chunk = find(chunk_of(x), chunk_of(y));
+    return chunk ? chunk->cells[cell_of(y) * CHUNK + cell_of(x)] : 0;
+}
+
+void SparseWorld::set_cell(int64_t x, int64_t y, uint8_t value) {
+    const int64_t cx = chunk_of(x);
+    const int64_t cy = chunk_of(y);
+    if (value == 0 && !find(cx, cy)) {
+        return;
+    }
+    Chunk *chunk = find_or_create(cx, cy);
+    uint8_t &cell = chunk->cells[cell_of(y) * CHUNK + cell_of(x)];
+    chunk->population += (value != 0) - (cell != 0);
+    cell = value;
+    if (chunk->population == 0) {
+        release(key(cx, cy));
+    }
+}
+
+void SparseWorld::write(const uint8_t *cells, int width, int height, int64_t x, int64_t y) {
+    for (int row = 0; row < height; row++) {
+        const uint8_t *src = cells + static_cast<int64_t>(row) * width;
+        for (int col = 0; col < width; col++) {
+            set_cell(x + col, y + row, src[col]);
+        }
+    }
+}
+
+void SparseWorld::read(uint8_t *out, int64_t x, int64_t y, int width, int height) const {
+    memset(out, 0, static_cast<size_t>(width) * height);
+    // Walk the chunks overlapping the rectangle and copy their row spans.
+    for (int64_t cy = chunk_of(y); cy <= chunk_of(y + height - 1); cy++) {
+        for (int64_t cx = chunk_of(x); cx <= chunk_of(x + width - 1); cx++) {
+            const Chunk *chunk = find(cx, cy);
+            if (!chunk) {
+                continue;
+            }
+            const int64_t x0 = std::max(x, cx * CHUNK);
+            const int64_t x1 = std::min(x + width, (cx + 1) * CHUNK);
+            const int64_t y0 = std::max(y, cy * CHUNK);
+            const int64_t y1 = std::min(y + height, (cy + 1) * CHUNK);
+            for (int64_t py = y0; py < y1; py++) {
+                memcpy(out + (py - y) * width + (x0 - x), chunk->cells + (py - cy * CHUNK) * CHUNK + (x0 - cx * CHUNK), static_cast<size_t>(x1 - x0));
+            }
+        }
+    }
+}
+
+bool SparseWorld::step_totalistic(uint16_t birth_mask, uint16_t survive_mask, WorkerPool &pool) {
+    if (birth_mask & 1) {
+        return false;
+    }
+
+    // Every allocated chunk, plus each neighbor that shares a border holding live cells.
+    std::vector<uint64_t> targets;
+    targets.reserve(chunks.size() * 2);
+    for (const auto &entry : chunks) {
+        const int64_t cx = key_x(entry.first);
+        const int64_t cy = key_y(entry.first);
+        const uint8_t *cells = entry.second->cells;
+        targets.push_back(entry.first);
+
+        const bool top = row_any(cells, 1, CHUNK);
+        const bool bottom = row_any(cells + (CHUNK - 1) * CHUNK, 1, CHUNK);
+        const bool left = row_any(cells, CHUNK, CHUNK);
+        const bool right = row_any(cells + CHUNK - 1, CHUNK, CHUNK);
+        if (top) {
+            targets.push_back(key(cx, cy - 1));
+        }
+        if (bottom) {
+            targets.push_back(key(cx, cy + 1));
+        }
+        if (left) {
+            targets.push_back(key(cx - 1, cy));
+        }
+        if (right) {
+            targets.push_back(key(cx + 1, cy));
+        }
+        if (cells[0]) {
+            targets.push_back(key(cx - 1, cy - 1));
+        }
+        if (cells[CHUNK - 1]) {
+            targets.push_back(key(cx + 1, cy - 1));
+        }
+        if (cells[(CHUNK - 1) * CHUNK]) {
+            targets.push_back(key(cx - 1, cy + 1));
+        }
+        if (cells[CHUNK_CELLS - 1]) {
+            targets.push_back(key(cx + 1, cy + 1));
+        }
+    }
+    std::sort(targets.begin(), targets.end());
+    targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+    std::vector<std::unique_ptr<Chunk>> next(targets.size());
+    for (std::unique_ptr<Chunk> &chunk : next) {
+        chunk = take_spare();
+    }
+    std::vector<uint8_t> changed(targets.size(), 0);
+
+    // Chunks are independent: each copies itself and a one-cell ring of its neighbors into a
+    // padded buffer and runs the byte kernels over the interior. The map is only read here.
+    pool.run(static_cast<uint32_t>(targets.size()), [&](uint32_t i) {
+        static thread_local std::vector<uint8_t> padded;
+        static thread_local std::vector<uint8_t> stepped;
+        padded.assign(PADDED * PADDED, 0);
+        stepped.resize(PADDED * PADDED);
+
+        const int64_t cx = key_x(targets[i]);
+        const int64_t cy = key_y(targets[i]);
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                const Chunk *chunk = find(cx + dx, cy + dy);
+                if (!chunk) {
+                    continue;
+                }
+                // Source span of this neighbor inside the padded buffer.
+                const int src_x0 = dx < 0 ? CHUNK - 1 : 0;
+                const int src_x1 = dx > 0 ? 1 : CHUNK;
+                const int src_y0 = dy < 0 ? CHUNK - 1 : 0;
+                const int src_y1 = dy > 0 ? 1 : CHUNK;
+                const int dst_x = dx < 0 ? 0 : (dx == 0 ? 1 : CHUNK + 1);
+                const int dst_y = dy < 0 ? 0 : (dy == 0 ? 1 : CHUNK + 1);
+                for (int sy = src_y0; sy < src_y1; sy++) {
+                    memcpy(padded.data() + (dst_y + sy - src_y0) * PADDED + dst_x, chunk->cells + sy * CHUNK + src_x0, static_cast<size_t>(src_x1 - src_x0));
+                }
+            }
+        }
+
+        changed[i] = step_bytes_block(padded.data(), stepped.data(), PADDED, PADDED, 1, PADDED - 1, 1, PADDED - 1, EDGE_FALLOFF, birth_mask, survive_mask);
+        uint8_t *out = next[i]->cells;
+        for (int y = 0; y < CHUNK; y++) {
+            memcpy(out + y * CHUNK, stepped.data() + (y + 1) * PADDED + 1, CHUNK);
+        }
+        next[i]->population = count_cells(out);
+    });
+
+    bool any_changed = false;
+    clear();
+    for (size_t i = 0; i < targets.size(); i++) {
+        any_changed |= changed[i] != 0;
+        if (next[i]->population > 0) {
+            chunks.emplace(targets[i], std::move(next[i]));
+        } else {
+            recycle(std::move(next[i]));
+        }
+    }
+    return any_changed;
+}
+
+bool SparseWorld::step_walkers(std::vector<Walker> &walkers, const bool turns[2]) {
+    std::vector<uint64_t> touched;
+    touched.reserve(walkers.size());
+    for (Walker &walker : walkers) {
+        const int64_t cx = chunk_of(walker.x);
+        const int64_t cy = chunk_of(walker.y);
+        Chunk *chunk = find_or_create(cx, cy);
+        uint8_t &cell = chunk->cells[cell_of(walker.y) * CHUNK + cell_of(walker.x)];
+        const int current = cell != 0;
+
+        int dir = walker.dir % 4;
+        if (dir < 0) {
+            dir += 4;
+        }
+        dir = turns[current] ? (dir + 1) % 4 : (dir + 3) % 4;
+        cell = static_cast<uint8_t>(1 - current);
+        chunk->population += current ? -1 : 1;
+        touched.push_back(key(cx, cy));
+
+        walker.dir = dir;
+        walker.x += DIR_X[dir];
+        walker.y += DIR_Y[dir];
+    }
+
+    for (uint64_t k : touched) {
+        const auto it = chunks.find(k);
+        if (it != chunks.end() && it->second->population == 0) {
+            release(k);
+        }
+    }
+    return !walkers.empty();
+}
+
+bool SparseWorld::step_ants(std::vector<Walker> &ants) {
+    const bool turns[2] = { false, true };
+    return step_walkers(ants, turns);
+}
+
+bool SparseWorld::step_turmites(std::vector<Walker> &turmites, const bool turns[2]) {
+    return step_walkers(turmites, turns);
+}
+
+uint64_t SparseWorld::get_population() const {
+    uint64_t population = 0;
+    for (const auto &entry : chunks) {
+        population += static_cast<uint64_t>(entry.second->population);
+    }
+    return population;
+}
+
+bool SparseWorld::get_bounds(int64_t &x0, int64_t &y0, int64_t &x1, int64_t &y1) const {
+    if (chunks.empty()) {
+        return false;
+    }
+    int64_t min_cx = std::numeric_limits<int64_t>::max();
+    int64_t min_cy = std::numeric_limits<int64_t>::max();
+    int64_t max_cx = std::numeric_limits<int64_t>::min();
+    int64_t max_cy = std::numeric_limits<int64_t>::min();
+    for (const auto &entry : chunks) {
+        min_cx = std::min(min_cx, key_x(entry.first));
+        min_cy = std::min(min_cy, key_y(entry.first));
+        max_cx = std::max(max_cx, key_x(entry.first));
+        max_cy = std::max(max_cy, key_y(entry.first));
+    }
+    x0 = min_cx * CHUNK;
+    y0 = min_cy * CHUNK;
+    x1 = (max_cx + 1) * CHUNK;
+    y1 = (max_cy + 1) * CHUNK;
+    return true;
+}
+
+} // namespace automata
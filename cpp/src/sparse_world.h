@@ -0,0 +1,85 @@
+#pragma once
+
+#include "worker_pool.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Unbounded byte grid made of CHUNK x CHUNK chunks allocated on demand.
+//
+// Chunks live in a hash map keyed by chunk coordinate (floor(x / CHUNK), floor(y / CHUNK)), so
+// memory follows the live area rather than the extent of the pattern. The plane has no edges
+// (EDGE_INFINITE in automata_common.h): everything outside an allocated chunk is dead. Chunks whose cells all become
+// zero are released after each step and by set_cell.
+
+namespace automata {
+
+class SparseWorld {
+public:
+    static constexpr int CHUNK = 64;
+    static constexpr int CHUNK_CELLS = CHUNK * CHUNK;
+
+    struct Walker {
+        int64_t x;
+        int64_t y;
+        int dir; // 0 up, 1 right, 2 down, 3 left, like the dense steppers.
+    };
+
+    SparseWorld() = default;
+    SparseWorld(const SparseWorld &) = delete;
+    SparseWorld &operator=(const SparseWorld &) = delete;
+
+    void clear();
+
+    uint8_t get_cell(int64_t x, int64_t y) const;
+    void set_cell(int64_t x, int64_t y, uint8_t value);
+
+    // Copies a width x height byte grid onto the plane with its top-left cell at (x, y);
+    // zero bytes clear the cells they cover.
+    void write(const uint8_t *cells, int width, int height, int64_t x, int64_t y);
+    // Writes the cells of the rectangle at (x, y) into `out` (width * height bytes).
+    void read(uint8_t *out, int64_t x, int64_t y, int width, int height) const;
+
+    // Advances one totalistic generation (cells are 0/1). Rules with B0 would fill the infinite
+    // plane and are rejected (returns false without stepping). Returns true when any cell changed.
+    bool step_totalistic(uint16_t birth_mask, uint16_t survive_mask, WorkerPool &pool);
+
+    // Moves Langton's ants one step each: turn right on a set cell, left on a clear one, flip it.
+    bool step_ants(std::vector<Walker> &ants);
+    // Turmites with a two-state turn string: turns[state] is true for a right turn.
+    bool step_turmites(std::vector<Walker> &turmites, const bool turns[2]);
+
+    size_t get_chunk_count() const { return chunks.size(); }
+    uint64_t get_population() const;
+    // Cell-space bounding box of all allocated chunks; false when the world is empty.
+    bool get_bounds(int64_t &x0, int64_t &y0, int64_t &x1, int64_t &y1) const;
+
+private:
+    struct Chunk {
+        uint8_t cells[CHUNK_CELLS];
+        int32_t population = 0;
+    };
+
+    static uint64_t key(int64_t cx, int64_t cy) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+    }
+    static int64_t key_x(uint64_t k) { return static_cast<int32_t>(k >> 32); }
+    static int64_t key_y(uint64_t k) { return static_cast<int32_t>(k & 0xFFFFFFFFu); }
+
+    const Chunk *find(int64_t cx, int64_t cy) const;
+    Chunk *find_or_create(int64_t cx, int64_t cy);
+    std::unique_ptr<Chunk> take_spare();
+    void recycle(std::unique_ptr<Chunk> chunk);
+    void release(uint64_t k);
+    bool step_walkers(std::vector<Walker> &walkers, const bool turns[2]);
+
+    std::unordered_map<uint64_t, std::unique_ptr<Chunk>> chunks;
+    // Released chunk buffers, reused before allocating new ones. Capped so a shrinking pattern
+    // returns its memory.
+    static constexpr size_t MAX_SPARE = 256;
+    std::vector<std::unique_ptr<Chunk>> spare;
+};
+
+} // namespace automata
@@ -0,0 +1,215 @@
+#include "steady_state.h"
+
+#include "simd_target.h"
+#include "totalistic_simd.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace automata {
+
+namespace {
+
+constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+
+inline uint64_t rotl(uint64_t v, int bits) {
+    return (v << bits) | (v >> (64 - bits));
+}
+
+inline uint64_t load_word(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t mix_round(uint64_t acc, uint64_t word) {
+    return rotl(acc + word * PRIME2, 31) * PRIME1;
+}
+
+// 64-byte stripes go into eight lanes with the XXH3 accumulate step (a 32x32->64 multiply of the
+// keyed word plus the neighboring lane's raw word). Both versions give identical lanes, so
+// hashes stay comparable when the SIMD level changes between calls.
+alignas(32) constexpr uint64_t KEYS[8] = {
+    0xBE4BA423396CFEB8ULL, 0x1CAD21F72C81017CULL, 0xDB979083E96DD4DEULL, 0x1F67B3B7A4A44072ULL,
+    0x78E5C0CC4EE679CBULL, 0x2172FFCC7DD05A82ULL, 0x8E2443F7744608B8ULL, 0x4C263A81E69035E0ULL,
+};
+
+// `stripes` stripes from each of `rows` rows, `stride` bytes apart.
+uint64_t accumulate_scalar(const uint8_t *data, size_t stride, int rows, size_t stripes, uint64_t lanes[8]) {
+    uint64_t bits = 0;
+    for (int r = 0; r < rows; r++) {
+        for (size_t s = 0; s < stripes; s++) {
+            const uint8_t *stripe = data + r * stride + s * 64;
+            for (int l = 0; l < 8; l++) {
+                const uint64_t word = load_word(stripe + l * 8);
+                const uint64_t keyed = word ^ KEYS[l];
+                lanes[l ^ 1] += word;
+                lanes[l] += (keyed & 0xFFFFFFFFULL) * (keyed >> 32);
+                bits |= word;
+            }
+        }
+    }
+    return bits;
+}
+
+#ifdef AUTOMATA_X86
+
+AUTOMATA_TARGET("avx2")
+uint64_t accumulate_avx2(const uint8_t *data, size_t stride, int rows, size_t stripes, uint64_t lanes[8]) {
+    const __m256i key_lo = _mm256_load_si256(reinterpret_cast<const __m256i *>(KEYS));
+    const __m256i key_hi = _mm256_load_si256(reinterpret_cast<const __m256i *>(KEYS + 4));
+    __m256i acc_lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes));
+    __m256i acc_hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes + 4));
+    __m256i bits = _mm256_setzero_si256();
+    for (int r = 0; r < rows; r++) {
+        const uint8_t *row = data + r * stride;
+        for (size_t s = 0; s < stripes; s++) {
+            const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + s * 64));
+            const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + s * 64 + 32));
+            const __m256i keyed_lo = _mm256_xor_si256(lo, key_lo);
+            const __m256i keyed_hi = _mm256_xor_si256(hi, key_hi);
+            acc_lo = _mm256_add_epi64(acc_lo, _mm256_mul_epu32(keyed_lo, _mm256_srli_epi64(keyed_lo, 32)));
+            acc_hi = _mm256_add_epi64(acc_hi, _mm256_mul_epu32(keyed_hi, _mm256_srli_epi64(keyed_hi, 32)));
+            acc_lo = _mm256_add_epi64(acc_lo, _mm256_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2)));
+            acc_hi = _mm256_add_epi64(acc_hi, _mm256_shuffle_epi32(hi, _MM_SHUFFLE(1, 0, 3, 2)));
+            bits = _mm256_or_si256(bits, _mm256_or_si256(lo, hi));
+        }
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), acc_lo);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes + 4), acc_hi);
+    return _mm256_testz_si256(bits, bits) ? 0 : 1;
+}
+
+#endif // AUTOMATA_X86
+
+} // namespace
+
+uint64_t hash_cells(const uint8_t *data, size_t size, bool &any_set) {
+    return hash_block(data, size, size, 1, 0, any_set);
+}
+
+uint64_t hash_block(const uint8_t *data, size_t stride, size_t span, int rows, uint64_t seed, bool &any_set) {
+    uint64_t lanes[8] = { PRIME3, PRIME1, PRIME2, PRIME3 ^ PRIME1, PRIME2 ^ PRIME3, PRIME1 + PRIME2, PRIME3 + PRIME1, PRIME2 + PRIME3 };
+    uint64_t bits = 0;
+    const size_t stripes = span / 64;
+#ifdef AUTOMATA_X86
+    if (active_simd_level() >= SIMD_AVX2) {
+        bits = accumulate_avx2(data, stride, rows, stripes, lanes);
+    } else {
+        bits = accumulate_scalar(data, stride, rows, stripes, lanes);
+    }
+#else
+    bits = accumulate_scalar(data, stride, rows, stripes, lanes);
+#endif
+
+    uint64_t h = (seed + static_cast<uint64_t>(span) * static_cast<uint64_t>(rows)) * PRIME1;
+    for (int l = 0; l < 8; l++) {
+        h = rotl(h ^ mix_round(0, lanes[l]), 27) * PRIME1 + PRIME3;
+    }
+    for (int r = 0; r < rows; r++) {
+        const uint8_t *row = data + r * stride;
+        size_t i = stripes * 64;
+        for (; i + 8 <= span; i += 8) {
+            const uint64_t word = load_word(row + i);
+            h = rotl(h ^ mix_round(0, word), 27) * PRIME1 + PRIME3;
+            bits |= word;
+        }
+        for (; i < span; i++) {
+            h = rotl(h ^ (row[i] * PRIME3), 11) * PRIME1;
+            bits |= row[i];
+        }
+    }
+
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    any_set = bits != 0;
+    return h;
+}
+
+void SteadyStateDetector::reset() {
+    count = 0;
+    next = 0;
+    generation = 0;
+    width = 0;
+    height = 0;
+    exact_period = 0;
+    status = SteadyStatus();
+}
+
+void SteadyStateDetector::hash_tile(const uint8_t *cells, int tx, int ty) {
+    const size_t index = static_cast<size_t>(ty) * tiles_x + tx;
+    const int x0 = tx * TILE;
+    const int y0 = ty * TILE;
+    const size_t span = static_cast<size_t>(std::min(width - x0, TILE));
+    const int rows = std::min(height - y0, TILE);
+    bool any_set = false;
+    const uint64_t hash = hash_block(cells + static_cast<size_t>(y0) * width + x0, static_cast<size_t>(width), span, rows, index, any_set);
+    grid_hash ^= tile_hashes[index] ^ hash;
+    tile_hashes[index] = hash;
+    set_tiles += static_cast<int>(any_set) - static_cast<int>(tile_set[index]);
+    tile_set[index] = any_set ? 1 : 0;
+}
+
+SteadyStatus SteadyStateDetector::observe(const uint8_t *cells, int p_width, int p_height, const uint8_t *dirty, bool changed, int generations, uint16_t birth_mask) {
+    generation += generations;
+    status = SteadyStatus();
+    exact_period = 0;
+
+    // Unchanged grids keep their hash: the stepper's flag is exact.
+    if (changed || count == 0) {
+        if (count == 0 || dirty == nullptr || p_width != width || p_height != height) {
+            width = p_width;
+            height = p_height;
+            tiles_x = (width + TILE - 1) / TILE;
+            tiles_y = (height + TILE - 1) / TILE;
+            tile_hashes.assign(static_cast<size_t>(tiles_x) * tiles_y, 0);
+            tile_set.assign(tile_hashes.size(), 0);
+            set_tiles = 0;
+            grid_hash = 0;
+            dirty = nullptr;
+        }
+        for (int ty = 0; ty < tiles_y; ty++) {
+            for (int tx = 0; tx < tiles_x; tx++) {
+                if (dirty == nullptr || dirty[static_cast<size_t>(ty) * tiles_x + tx]) {
+                    hash_tile(cells, tx, ty);
+                }
+            }
+        }
+    }
+    const uint64_t hash = grid_hash;
+    const bool any_set = set_tiles > 0;
+
+    if (!any_set && !(birth_mask & 1)) {
+        status.kind = STEADY_EXTINCT;
+        status.period = 1;
+        exact_period = 1;
+    } else if (!changed) {
+        status.kind = generations == 1 ? STEADY_STILL : STEADY_PERIODIC;
+        status.period = generations;
+        exact_period = generations;
+    } else {
+        // Newest first, so the smallest repeat distance wins.
+        for (int i = 1; i <= count; i++) {
+            const Entry &entry = history[(next - i + HISTORY) % HISTORY];
+            if (entry.hash == hash) {
+                status.kind = STEADY_PERIODIC;
+                status.period = generation - entry.generation;
+                break;
+            }
+        }
+    }
+
+    history[next] = { hash, generation };
+    next = (next + 1) % HISTORY;
+    if (count < HISTORY) {
+        count++;
+    }
+    return status;
+}
+
+} // namespace automata
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "totalistic_active.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Settling detection for repeated grid steps.
+//
+// Every observed generation is reduced to a 64-bit hash and kept in a short ring. A grid that
+// did not change is still, an empty grid is extinct unless the rule has B0, and a hash that
+// reappears means the grid returned to an earlier state, so it repeats with the generation
+// difference as period.
+// The grid hash is the XOR of per-tile hashes over the ActiveTileTracker tiles, so a step that
+// reports its changed tiles only rehashes those; other steps rehash every tile, which reads the
+// grid once. Hashing is skipped when the step reported no change.
+//
+// Still and extinct grids, and batches that left the grid unchanged, are known exactly from the
+// stepper's change flag, so the caller may skip later steps of a multiple of that many
+// generations. Hash-detected periods are only reported.
+
+namespace automata {
+
+enum SteadyKind {
+    STEADY_ACTIVE,
+    STEADY_STILL,
+    STEADY_PERIODIC,
+    STEADY_EXTINCT,
+};
+
+struct SteadyStatus {
+    SteadyKind kind = STEADY_ACTIVE;
+    // Generations between repeats: 1 for still and extinct grids, 0 while active.
+    int64_t period = 0;
+};
+
+// Non-cryptographic hash of a cell buffer; `any_set` reports whether any byte is non-zero.
+uint64_t hash_cells(const uint8_t *data, size_t size, bool &any_set);
+// Same hash over `rows` rows of `span` bytes, `stride` bytes apart, mixed with `seed`.
+uint64_t hash_block(const uint8_t *data, size_t stride, size_t span, int rows, uint64_t seed, bool &any_set);
+
+class SteadyStateDetector {
+public:
+    static constexpr int HISTORY = 64;
+    static constexpr int TILE = ActiveTileTracker::TILE;
+
+    // Forgets all recorded generations.
+    void reset();
+
+    // Records the grid reached `generations` steps after the previous observation. `changed`
+    // is the stepper's own change flag. When steps are batched, a reported period is the first
+    // multiple of the batch size at which the grid repeats. `birth_mask` is the rule's birth
+    // set: with B0 an empty grid fills up, so it only counts as extinct without it. `dirty`, when
+    // given, flags the TILE x TILE tiles (row-major) that differ from the last observed grid, as
+    // ActiveTileTracker::get_changed() does; only those are rehashed.
+    SteadyStatus observe(const uint8_t *cells, int width, int height, const uint8_t *dirty, bool changed, int generations, uint16_t birth_mask);
+
+    // True when stepping the last observed grid by `generations` is known to return it unchanged.
+    bool can_skip(int generations) const { return exact_period > 0 && generations % exact_period == 0; }
+
+    // Advances the generation counter for a step the caller skipped after can_skip().
+    void skip(int generations) { generation += generations; }
+
+    SteadyStatus get_status() const { return status; }
+    int64_t get_generation() const { return generation; }
+
+private:
+    struct Entry {
+        uint64_t hash;
+        int64_t generation;
+    };
+
+    void hash_tile(const uint8_t *cells, int tx, int ty);
+
+    Entry history[HISTORY];
+    int count = 0;
+    int next = 0;
+    int64_t generation = 0;
+    // Per-tile hashes of the last observed grid, their XOR and how many tiles have a live cell.
+    int width = 0;
+    int height = 0;
+    int tiles_x = 0;
+    int tiles_y = 0;
+    std::vector<uint64_t> tile_hashes;
+    std::vector<uint8_t> tile_set;
+    int64_t set_tiles = 0;
+    uint64_t grid_hash = 0;
+    // Period confirmed by the change flag rather than by a hash match; 0 when unknown.
+    int64_t exact_period = 0;
+    SteadyStatus status;
+};
+
+} // namespace automata
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+// Wall-clock budget for the run_for style methods.
+//
+// take() hands out steps until the time is spent: the first call always grants one step so there
+// is progress and a measurement, and later calls grant as many steps as the average so far says
+// still fit in what is left. Callers that can batch (temporally blocked totalistic steps) ask for
+// many at once; the rest ask for one at a time. Overshoot is bounded by one step's variance
+// rather than by however many steps a frame happened to accumulate.
+
+namespace automata {
+
+class StepBudget {
+public:
+    // budget_usec <= 0 grants exactly one step; max_steps <= 0 means no step cap.
+    StepBudget(int64_t p_budget_usec, int64_t p_max_steps) :
+            start(Clock::now()), budget_usec(p_budget_usec), max_steps(p_max_steps) {}
+
+    // Grants up to `limit` more steps, 0 once the budget or the step cap is used up. Every step
+    // granted earlier is assumed to have finished.
+    int64_t take(int64_t limit = 1) {
+        int64_t count = limit;
+        if (max_steps > 0) {
+            count = std::min(count, max_steps - granted);
+        }
+        if (count <= 0) {
+            return 0;
+        }
+        if (granted > 0) {
+            const int64_t elapsed = elapsed_usec();
+            const int64_t left = budget_usec - elapsed;
+            if (left <= 0) {
+                return 0;
+            }
+            // Steps that finish inside the clock resolution count as free; the cap still applies.
+            if (elapsed > 0) {
+                count = std::min(count, static_cast<int64_t>(static_cast<double>(left) * granted / elapsed));
+            }
+            if (count <= 0) {
+                return 0;
+            }
+        } else {
+            count = 1;
+        }
+        granted += count;
+        return count;
+    }
+
+    int64_t get_steps() const { return granted; }
+    int64_t elapsed_usec() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point start;
+    int64_t budget_usec = 0;
+    int64_t max_steps = 0;
+    int64_t granted = 0;
+};
+
+} // namespace automata
@@ -0,0 +1,127 @@
+#include "totalistic_active.h"
+
+#include "automata_common.h"
+#include "totalistic_simd.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace automata {
+
+namespace {
+
+bool tile_differs(const uint8_t *a, const uint8_t *b, int width, int x0, int x1, int y0, int y1) {
+    const size_t span = static_cast<size_t>(x1 - x0);
+    for (int y = y0; y < y1; y++) {
+        const int64_t offset = static_cast<int64_t>(y) * width + x0;
+        if (memcmp(a + offset, b + offset, span) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+void ActiveTileTracker::reset(int p_width, int p_height, int p_edge_mode, uint16_t p_birth_mask, uint16_t p_survive_mask) {
+    width = p_width;
+    height = p_height;
+    edge_mode = p_edge_mode;
+    birth_mask = p_birth_mask;
+    survive_mask = p_survive_mask;
+    tiles_x = (width + TILE - 1) / TILE;
+    tiles_y = (height + TILE - 1) / TILE;
+    changed.assign(static_cast<size_t>(tiles_x) * tiles_y, 0);
+    active.assign(changed.size(), 0);
+    active_count = 0;
+    full = true;
+}
+
+bool ActiveTileTracker::matches(int p_width, int p_height, int p_edge_mode, uint16_t p_birth_mask, uint16_t p_survive_mask) const {
+    return width == p_width && height == p_height && edge_mode == p_edge_mode && birth_mask == p_birth_mask && survive_mask == p_survive_mask;
+}
+
+void ActiveTileTracker::mark_diff(const uint8_t *a, const uint8_t *b) {
+    for (int ty = 0; ty < tiles_y; ty++) {
+        const int y_end = std::min(height, (ty + 1) * TILE);
+        for (int tx = 0; tx < tiles_x; tx++) {
+            uint8_t &flag = changed[static_cast<size_t>(ty) * tiles_x + tx];
+            if (flag) {
+                continue;
+            }
+            const int x0 = tx * TILE;
+            flag = tile_differs(a, b, width, x0, std::min(width, x0 + TILE), ty * TILE, y_end) ? 1 : 0;
+        }
+    }
+}
+
+void ActiveTileTracker::build_active() {
+    std::fill(active.begin(), active.end(), 0);
+    const bool wrap = edge_mode == EDGE_WRAP;
+    for (int ty = 0; ty < tiles_y; ty++) {
+        for (int tx = 0; tx < tiles_x; tx++) {
+            if (!changed[static_cast<size_t>(ty) * tiles_x + tx]) {
+                continue;
+            }
+            for (int dy = -1; dy <= 1; dy++) {
+                int ny = ty + dy;
+                if (ny < 0 || ny >= tiles_y) {
+                    if (!wrap) {
+                        continue;
+                    }
+                    ny = wrap_axis(ny, tiles_y);
+                }
+                for (int dx = -1; dx <= 1; dx++) {
+                    int nx = tx + dx;
+                    if (nx < 0 || nx >= tiles_x) {
+                        if (!wrap) {
+                            continue;
+                        }
+                        nx = wrap_axis(nx, tiles_x);
+                    }
+                    active[static_cast<size_t>(ny) * tiles_x + nx] = 1;
+                }
+            }
+        }
+    }
+}
+
+bool ActiveTileTracker::step(const uint8_t *src, uint8_t *dst, WorkerPool &pool) {
+    if (full) {
+        std::fill(active.begin(), active.end(), 1);
+        full = false;
+    } else {
+        build_active();
+    }
+    active_count = static_cast<int>(std::count(active.begin(), active.end(), 1));
+    if (active_count == 0) {
+        std::fill(changed.begin(), changed.end(), 0);
+        return false;
+    }
+
+    pool.run(static_cast<uint32_t>(tiles_y), [&](uint32_t ty) {
+        const int y0 = static_cast<int>(ty) * TILE;
+        const int y1 = std::min(height, y0 + TILE);
+        const size_t row_base = static_cast<size_t>(ty) * tiles_x;
+        int tx = 0;
+        while (tx < tiles_x) {
+            if (!active[row_base + tx]) {
+                changed[row_base + tx] = 0;
+                tx++;
+                continue;
+            }
+            // Step each run of adjacent active tiles as one block so the row kernels stay wide.
+            int run_end = tx;
+            while (run_end < tiles_x && active[row_base + run_end]) {
+                run_end++;
+            }
+            step_bytes_block(src, dst, width, height, y0, y1, tx * TILE, std::min(width, run_end * TILE), edge_mode, birth_mask, survive_mask);
+            for (; tx < run_end; tx++) {
+                changed[row_base + tx] = tile_differs(src, dst, width, tx * TILE, std::min(width, (tx + 1) * TILE), y0, y1) ? 1 : 0;
+            }
+        }
+    });
+    return std::find(changed.begin(), changed.end(), 1) != changed.end();
+}
+
+} // namespace automata
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "worker_pool.h"
+
+#include <cstdint>
+#include <vector>
+
+// Activity tracking for repeated byte-grid totalistic steps.
+//
+// The grid is divided into TILE x TILE tiles. A tile whose cells and neighbors did not change in
+// the previous generation cannot change in the next one, so only tiles that changed (or border
+// a tile that did) are recomputed. The caller keeps the output of the step before last as the
+// destination buffer, which already holds the right values for every skipped tile.
+
+namespace automata {
+
+class ActiveTileTracker {
+public:
+    static constexpr int TILE = 64;
+
+    // Forgets all history; the next step recomputes every tile.
+    void reset(int width, int height, int edge_mode, uint16_t birth_mask, uint16_t survive_mask);
+    bool matches(int width, int height, int edge_mode, uint16_t birth_mask, uint16_t survive_mask) const;
+
+    // Marks tiles where `a` and `b` differ as changed (used for edits made between steps).
+    void mark_diff(const uint8_t *a, const uint8_t *b);
+
+    // Advances active tiles from `src` into `dst`; other tiles of `dst` must already equal `src`.
+    // Returns true when any cell changed.
+    bool step(const uint8_t *src, uint8_t *dst, WorkerPool &pool);
+
+    int get_tiles_x() const { return tiles_x; }
+    int get_tiles_y() const { return tiles_y; }
+    int get_active_count() const { return active_count; }
+    // One byte per tile (row-major), 1 when the tile changed in the last step.
+    const std::vector<uint8_t> &get_changed() const { return changed; }
+
+private:
+    void build_active();
+
+    int width = 0;
+    int height = 0;
+    int edge_mode = -1;
+    uint16_t birth_mask = 0;
+    uint16_t survive_mask = 0;
+    int tiles_x = 0;
+    int tiles_y = 0;
+    int active_count = 0;
+    bool full = true;
+    std::vector<uint8_t> changed;
+    std::vector<uint8_t> active;
+};
+
+} // namespace automata
@@ -0,0 +1,197 @@
+#include "totalistic_bits.h"
+
+#include "totalistic_rules.h"
+
+#include <vector>
+
+namespace automata {
+
+namespace {
+
+struct RowShifts {
+    uint64_t west; // cell x-1 at bit x
+    uint64_t center;
+    uint64_t east; // cell x+1 at bit x
+};
+
+inline uint64_t cell_bit(const uint64_t *row, int x) {
+    return (row[x >> 6] >> (x & 63)) & 1ULL;
+}
+
+// Values of the virtual cells at x = -1 and x = width for one row.
+template <int EDGE>
+inline void edge_cells(const uint64_t *row, int width, uint64_t &left, uint64_t &right) {
+    if constexpr (EDGE == EDGE_WRAP) {
+        left = cell_bit(row, width - 1);
+        right = cell_bit(row, 0);
+    } else if constexpr (EDGE == EDGE_BOUNCE) {
+        left = cell_bit(row, 0);
+        right = cell_bit(row, width - 1);
+    } else {
+        left = 0;
+        right = 0;
+    }
+}
+
+inline RowShifts shift_word(const uint64_t *row, int word, int words, int width, uint64_t left, uint64_t right) {
+    const uint64_t w = row[word];
+    const uint64_t prev = word > 0 ? row[word - 1] : (left << 63);
+    const uint64_t next = word + 1 < words ? row[word + 1] : right;
+
+    RowShifts s;
+    s.center = w;
+    s.west = (w << 1) | (prev >> 63);
+    s.east = (w >> 1) | (next << 63);
+    if (word + 1 == words && (width & 63) != 0) {
+        // The last column's east neighbor sits in the padding; inject the edge value there.
+        s.east |= right << ((width - 1) & 63);
+    }
+    return s;
+}
+
+inline void full_add(uint64_t a, uint64_t b, uint64_t c, uint64_t &sum, uint64_t &carry) {
+    const uint64_t t = a ^ b;
+    sum = t ^ c;
+    carry = (a & b) | (t & c);
+}
+
+template <typename Rule>
+inline uint64_t apply_rule(const Rule &rule, uint64_t alive, const uint64_t n[8]) {
+    uint64_t s0a, c0a, s0b, c0b;
+    full_add(n[0], n[1], n[2], s0a, c0a);
+    full_add(n[3], n[4], n[5], s0b, c0b);
+    const uint64_t s0c = n[6] ^ n[7];
+    const uint64_t c0c = n[6] & n[7];
+
+    uint64_t bit0, c1;
+    full_add(s0a, s0b, s0c, bit0, c1);
+
+    uint64_t s2, c2;
+    full_add(c0a, c0b, c0c, s2, c2);
+    const uint64_t bit1 = s2 ^ c1;
+    const uint64_t c3 = s2 & c1;
+    const uint64_t bit2 = c2 ^ c3;
+    const uint64_t bit3 = c2 & c3;
+
+    return rule.next(alive, bit0, bit1, bit2, bit3);
+}
+
+template <int EDGE, typename Rule>
+bool step_row(const uint64_t *up, const uint64_t *mid, const uint64_t *down, uint64_t *out, int width, const Rule &rule) {
+    const int words = words_per_row(width);
+    uint64_t up_left, up_right, mid_left, mid_right, down_left, down_right;
+    edge_cells<EDGE>(up, width, up_left, up_right);
+    edge_cells<EDGE>(mid, width, mid_left, mid_right);
+    edge_cells<EDGE>(down, width, down_left, down_right);
+
+    uint64_t diff = 0;
+    for (int w = 0; w < words; w++) {
+        const RowShifts u = shift_word(up, w, words, width, up_left, up_right);
+        const RowShifts m = shift_word(mid, w, words, width, mid_left, mid_right);
+        const RowShifts d = shift_word(down, w, words, width, down_left, down_right);
+        const uint64_t neighbors[8] = { u.west, u.center, u.east, m.west, m.east, d.west, d.center, d.east };
+
+        uint64_t next = apply_rule(rule, m.center, neighbors);
+        if (w + 1 == words) {
+            next &= last_word_mask(width);
+        }
+        out[w] = next;
+        diff |= next ^ m.center;
+    }
+    return diff != 0;
+}
+
+template <int EDGE, typename Rule>
+bool step_rows(const uint64_t *src, uint64_t *dst, int width, int height, int row_begin, int row_end, const Rule &rule) {
+    const int words = words_per_row(width);
+    // Falloff rows outside the grid read as dead.
+    static thread_local std::vector<uint64_t> zero_words;
+    if (zero_words.size() < static_cast<size_t>(words)) {
+        zero_words.assign(words, 0);
+    }
+    const uint64_t *zero_row = zero_words.data();
+
+    bool changed = false;
+    for (int y = row_begin; y < row_end; y++) {
+        const uint64_t *up;
+        const uint64_t *down;
+        if constexpr (EDGE == EDGE_WRAP) {
+            up = src + static_cast<int64_t>(wrap_axis(y - 1, height)) * words;
+            down = src + static_cast<int64_t>(wrap_axis(y + 1, height)) * words;
+        } else if constexpr (EDGE == EDGE_BOUNCE) {
+            up = src + static_cast<int64_t>(clamp_axis(y - 1, height)) * words;
+            down = src + static_cast<int64_t>(clamp_axis(y + 1, height)) * words;
+        } else {
+            up = y > 0 ? src + static_cast<int64_t>(y - 1) * words : zero_row;
+            down = y + 1 < height ? src + static_cast<int64_t>(y + 1) * words : zero_row;
+        }
+        const int64_t offset = static_cast<int64_t>(y) * words;
+        changed |= step_row<EDGE>(up, src + offset, down, dst + offset, width, rule);
+    }
+    return changed;
+}
+
+template <int EDGE>
+bool step_rows_for_rule(const uint64_t *src, uint64_t *dst, int width, int height, int row_begin, int row_end, uint16_t birth_mask, uint16_t survive_mask) {
+    switch (builtin_rule(birth_mask, survive_mask)) {
+        case RULE_LIFE:
+            return step_rows<EDGE>(src, dst, width, height, row_begin, row_end, FixedRule<LIFE_BIRTH, LIFE_SURVIVE>());
+        case RULE_DAY_NIGHT:
+            return step_rows<EDGE>(src, dst, width, height, row_begin, row_end, FixedRule<DAY_NIGHT_BIRTH, DAY_NIGHT_SURVIVE>());
+        case RULE_SEEDS:
+            return step_rows<EDGE>(src, dst, width, height, row_begin, row_end, FixedRule<SEEDS_BIRTH, SEEDS_SURVIVE>());
+        default:
+            return step_rows<EDGE>(src, dst, width, height, row_begin, row_end, RuntimeRule{ birth_mask, survive_mask });
+    }
+}
+
+} // namespace
+
+void pack_rows(const uint8_t *src, int width, int height, uint64_t *dst) {
+    const int words = words_per_row(width);
+    for (int y = 0; y < height; y++) {
+        const uint8_t *row = src + static_cast<int64_t>(y) * width;
+        uint64_t *out = dst + static_cast<int64_t>(y) * words;
+        for (int w = 0; w < words; w++) {
+            const int base = w << 6;
+            const int count = width - base < 64 ? width - base : 64;
+            uint64_t bits = 0;
+            int i = 0;
+            for (; i + 8 <= count; i += 8) {
+                bits |= pack_byte_lanes(row + base + i) << i;
+            }
+            for (; i < count; i++) {
+                bits |= static_cast<uint64_t>(row[base + i] != 0) << i;
+            }
+            out[w] = bits;
+        }
+    }
+}
+
+void unpack_rows(const uint64_t *src, int width, int height, uint8_t *dst) {
+    const int words = words_per_row(width);
+    for (int y = 0; y < height; y++) {
+        const uint64_t *row = src + static_cast<int64_t>(y) * words;
+        uint8_t *out = dst + static_cast<int64_t>(y) * width;
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            unpack_byte_lanes(row[x >> 6] >> (x & 63), out + x);
+        }
+        for (; x < width; x++) {
+            out[x] = static_cast<uint8_t>((row[x >> 6] >> (x & 63)) & 1ULL);
+        }
+    }
+}
+
+bool step_bits_rows(const uint64_t *src, uint64_t *dst, int width, int height, int row_begin, int row_end, int edge_mode, uint16_t birth_mask, uint16_t survive_mask) {
+    switch (edge_mode) {
+        case EDGE_WRAP:
+            return step_rows_for_rule<EDGE_WRAP>(src, dst, width, height, row_begin, row_end, birth_mask, survive_mask);
+        case EDGE_BOUNCE:
+            return step_rows_for_rule<EDGE_BOUNCE>(src, dst, width, height, row_begin, row_end, birth_mask, survive_mask);
+        default:
+            return step_rows_for_rule<EDGE_FALLOFF>(src, dst, width, height, row_begin, row_end, birth_mask, survive_mask);
+    }
+}
+
+} // namespace automata
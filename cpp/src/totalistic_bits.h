@@ -0,0 +1,56 @@
+#pragma once
+
+#include "automata_common.h"
+
+#include <cstdint>
+#include <cstring>
+
+// Bit-packed storage for binary totalistic automata (GoL, Day & Night, Seeds).
+//
+// Each row is stored as `words_per_row(width)` little-endian 64-bit words: cell x of a row
+// lives in bit (x & 63) of word (x >> 6). Padding bits past the last column are always zero.
+// Neighbor counts are produced with a bitwise full-adder tree, so one word op advances 64 cells.
+
+namespace automata {
+
+inline int words_per_row(int width) {
+    return (width + 63) >> 6;
+}
+
+inline uint64_t last_word_mask(int width) {
+    const int tail = width & 63;
+    return tail == 0 ? ~0ULL : ((1ULL << tail) - 1ULL);
+}
+
+// Eight cells per multiply: bytes (little-endian, cell i in byte i) folded to 0/1, then gathered
+// into the top byte, where every cell lands on its own bit without carries.
+inline uint64_t pack_byte_lanes(const uint8_t *src) {
+    uint64_t lanes;
+    memcpy(&lanes, src, sizeof(lanes));
+    lanes |= (lanes >> 4) & 0x0F0F0F0F0F0F0F0FULL;
+    lanes |= (lanes >> 2) & 0x0303030303030303ULL;
+    lanes |= (lanes >> 1) & 0x0101010101010101ULL;
+    lanes &= 0x0101010101010101ULL;
+    return (lanes * 0x0102040810204080ULL) >> 56;
+}
+
+// The inverse: broadcast eight bits to every byte, keep bit i in byte i and fold it to 0/1.
+inline void unpack_byte_lanes(uint64_t bits, uint8_t *dst) {
+    const uint64_t spread = ((bits & 0xFFULL) * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+    const uint64_t lanes = (((spread + 0x7F7F7F7F7F7F7F7FULL) | spread) >> 7) & 0x0101010101010101ULL;
+    memcpy(dst, &lanes, sizeof(lanes));
+}
+
+// Packs a one-byte-per-cell grid (any non-zero byte counts as alive) into `dst`,
+// which must hold `height * words_per_row(width)` words.
+void pack_rows(const uint8_t *src, int width, int height, uint64_t *dst);
+
+// Expands packed rows back into 0/1 bytes.
+void unpack_rows(const uint64_t *src, int width, int height, uint8_t *dst);
+
+// Advances rows [row_begin, row_end) of a packed grid by one generation. Birth / survive masks
+// use bit n for "n live neighbors"; B3/S23, B3678/S34678 and B2/S get dedicated kernels, and every
+// kernel is instantiated per edge mode. `src` and `dst` must not alias. Returns true when any row changed.
+bool step_bits_rows(const uint64_t *src, uint64_t *dst, int width, int height, int row_begin, int row_end, int edge_mode, uint16_t birth_mask, uint16_t survive_mask);
+
+} // namespace automata
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+
+// Built-in totalistic rules that get dedicated kernel instantiations, plus the evaluation of a
+// rule on bit-sliced neighbor counts. Masks use bit n for "n live neighbors".
+
+namespace automata {
+
+constexpr uint16_t LIFE_BIRTH = 1 << 3; // B3/S23
+constexpr uint16_t LIFE_SURVIVE = (1 << 2) | (1 << 3);
+constexpr uint16_t DAY_NIGHT_BIRTH = (1 << 3) | (1 << 6) | (1 << 7) | (1 << 8); // B3678/S34678
+constexpr uint16_t DAY_NIGHT_SURVIVE = (1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8);
+constexpr uint16_t SEEDS_BIRTH = 1 << 2; // B2/S
+constexpr uint16_t SEEDS_SURVIVE = 0;
+
+enum BuiltinRule {
+    RULE_GENERIC,
+    RULE_LIFE,
+    RULE_DAY_NIGHT,
+    RULE_SEEDS,
+};
+
+inline BuiltinRule builtin_rule(uint16_t birth_mask, uint16_t survive_mask) {
+    if (birth_mask == LIFE_BIRTH && survive_mask == LIFE_SURVIVE) {
+        return RULE_LIFE;
+    }
+    if (birth_mask == DAY_NIGHT_BIRTH && survive_mask == DAY_NIGHT_SURVIVE) {
+        return RULE_DAY_NIGHT;
+    }
+    if (birth_mask == SEEDS_BIRTH && survive_mask == SEEDS_SURVIVE) {
+        return RULE_SEEDS;
+    }
+    return RULE_GENERIC;
+}
+
+// Next state for 64 cells given the alive word and the four bits of their neighbor counts.
+// With compile-time masks the count loop folds into a fixed, branch-free boolean expression.
+template <uint16_t BIRTH, uint16_t SURVIVE>
+struct FixedRule {
+    static inline uint64_t next(uint64_t alive, uint64_t bit0, uint64_t bit1, uint64_t bit2, uint64_t bit3) {
+        uint64_t result = 0;
+        for (int count = 0; count <= 8; count++) {
+            const bool born = (BIRTH >> count) & 1;
+            const bool survives = (SURVIVE >> count) & 1;
+            if (!born && !survives) {
+                continue;
+            }
+            const uint64_t eq = ((count & 1) ? bit0 : ~bit0) & ((count & 2) ? bit1 : ~bit1) &
+                                ((count & 4) ? bit2 : ~bit2) & ((count & 8) ? bit3 : ~bit3);
+            const uint64_t state = born && survives ? ~0ULL : (born ? ~alive : alive);
+            result |= eq & state;
+        }
+        return result;
+    }
+};
+
+// B3/S23: exactly three neighbors, or two while alive.
+template <>
+struct FixedRule<LIFE_BIRTH, LIFE_SURVIVE> {
+    static inline uint64_t next(uint64_t alive, uint64_t bit0, uint64_t bit1, uint64_t bit2, uint64_t bit3) {
+        return bit1 & ~bit2 & ~bit3 & (bit0 | alive);
+    }
+};
+
+// Any other rule: masks come from the caller, terms without a set bit are skipped.
+struct RuntimeRule {
+    uint16_t birth_mask;
+    uint16_t survive_mask;
+
+    inline uint64_t next(uint64_t alive, uint64_t bit0, uint64_t bit1, uint64_t bit2, uint64_t bit3) const {
+        uint64_t result = 0;
+        const uint16_t any_mask = birth_mask | survive_mask;
+        for (int count = 0; count <= 8; count++) {
+            if (!(any_mask & (1 << count))) {
+                continue;
+            }
+            const uint64_t eq = ((count & 1) ? bit0 : ~bit0) & ((count & 2) ? bit1 : ~bit1) &
+                                ((count & 4) ? bit2 : ~bit2) & ((count & 8) ? bit3 : ~bit3);
+            uint64_t state = 0;
+            if (birth_mask & (1 << count)) {
+                state |= ~alive;
+            }
+            if (survive_mask & (1 << count)) {
+                state |= alive;
+            }
+            result |= eq & state;
+        }
+        return result;
+    }
+};
+
+} // namespace automata
@@ -0,0 +1,500 @@
+#include "totalistic_simd.h"
+
+#include "simd_target.h"
+#include "totalistic_rules.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#ifdef AUTOMATA_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace automata {
+
+namespace {
+
+// Next state indexed by neighbor count. Byte shuffles look up within 16-byte lanes, so the
+// 16-entry table is repeated for every lane of the widest vector; entries past 8 stay zero.
+// `neighborhood` maps a whole 3x3 window to the next state and is only filled for the
+// generic scalar kernel.
+struct RuleTables {
+    alignas(64) uint8_t birth[64] = {};
+    alignas(64) uint8_t survive[64] = {};
+    uint8_t neighborhood[512];
+};
+
+void fill_count_tables(RuleTables &t, uint16_t birth_mask, uint16_t survive_mask) {
+    for (int i = 0; i < 64; i++) {
+        const int n = i & 15;
+        t.birth[i] = n < 9 ? (birth_mask >> n) & 1 : 0;
+        t.survive[i] = n < 9 ? (survive_mask >> n) & 1 : 0;
+    }
+}
+
+// Window bits: column x - 1 in bits 0-2, x in bits 3-5, x + 1 in bits 6-8; within a column
+// the up, mid and down cells take one bit each, so the center cell is bit 4.
+void fill_neighborhood_table(RuleTables &t, uint16_t birth_mask, uint16_t survive_mask) {
+    for (int window = 0; window < 512; window++) {
+        const int alive = (window >> 4) & 1;
+        int n = -alive;
+        for (int bit = 0; bit < 9; bit++) {
+            n += (window >> bit) & 1;
+        }
+        t.neighborhood[window] = ((alive ? survive_mask : birth_mask) >> n) & 1;
+    }
+}
+
+// Recently used rules with their tables, per thread. The active stepper and SparseWorld call
+// step_bytes_block once per tile run or chunk with the same rule, so tables are built once per
+// rule rather than per call; a few entries keep rules stepped in turn (one per automaton) warm.
+struct CachedRule {
+    uint32_t key = UINT32_MAX;
+    bool has_neighborhood = false;
+    RuleTables tables;
+};
+constexpr int RULE_CACHE_SIZE = 4;
+
+const RuleTables &rule_tables(uint16_t birth_mask, uint16_t survive_mask, bool need_neighborhood) {
+    static thread_local CachedRule cache[RULE_CACHE_SIZE];
+    static thread_local int next_slot = 0;
+    const uint32_t key = static_cast<uint32_t>(birth_mask) | (static_cast<uint32_t>(survive_mask) << 16);
+    CachedRule *entry = nullptr;
+    for (CachedRule &candidate : cache) {
+        if (candidate.key == key) {
+            entry = &candidate;
+            break;
+        }
+    }
+    if (entry == nullptr) {
+        entry = &cache[next_slot];
+        next_slot = (next_slot + 1) % RULE_CACHE_SIZE;
+        entry->key = key;
+        entry->has_neighborhood = false;
+        fill_count_tables(entry->tables, birth_mask, survive_mask);
+    }
+    if (need_neighborhood && !entry->has_neighborhood) {
+        fill_neighborhood_table(entry->tables, birth_mask, survive_mask);
+        entry->has_neighborhood = true;
+    }
+    return entry->tables;
+}
+
+using RowKernel = bool (*)(const uint8_t *up, const uint8_t *mid, const uint8_t *down, uint8_t *out, int begin, int end, const RuleTables &t);
+
+// Interior columns only: x - 1 and x + 1 must be inside the row for every x in [begin, end).
+bool row_scalar(const uint8_t *up, const uint8_t *mid, const uint8_t *down, uint8_t *out, int begin, int end, const RuleTables &t) {
+    uint8_t diff = 0;
+    for (int x = begin; x < end; x++) {
+        const int n = up[x - 1] + up[x] + up[x + 1] + mid[x - 1] + mid[x + 1] + down[x - 1] + down[x] + down[x + 1];
+        const uint8_t next = mid[x] == 1 ? t.survive[n] : t.birth[n];
+        out[x] = next;
+        diff |= next ^ mid[x];
+    }
+    return diff != 0;
+}
+
+// Built-in rule with the masks folded into the count comparison.
+template <uint16_t BIRTH, uint16_t SURVIVE>
+bool row_fixed(const uint8_t *up, const uint8_t *mid, const uint8_t *down, uint8_t *out, int begin, int end, const RuleTables &) {
+    uint8_t diff = 0;
+    for (int x = begin; x < end; x++) {
+        const int n = up[x - 1] + up[x] + up[x + 1] + mid[x - 1] + mid[x + 1] + down[x - 1] + down[x] + down[x + 1];
+        const uint8_t next = static_cast<uint8_t>(((mid[x] == 1 ? SURVIVE : BIRTH) >> n) & 1);
+        out[x] = next;
+        diff |= next ^ mid[x];
+    }
+    return diff != 0;
+}
+
+inline int column_bits(const uint8_t *up, const uint8_t *mid, const uint8_t *down, int x) {
+    return up[x] | (mid[x] << 1) | (down[x] << 2);
+}
+
+// Any other rule: slide a 9-bit window across the row and look the next state up directly.
+bool row_lut512(const uint8_t *up, const uint8_t *mid, const uint8_t *down, uint8_t *out, int begin, int end, const RuleTables &t) {
+    if (begin >= end) {
+        return false;
+    }
+    int window = (column_bits(up, mid, down, begin - 1) << 3) | (column_bits(up, mid, down, begin) << 6);
+    uint8_t diff = 0;
+    for (int x = begin; x < end; x++) {
+        window = (window >> 3) | (column_bits(up, mid, down, x + 1) << 6);
+        const uint8_t next = t.neighborhood[window];
+        out[x] = next;
+        diff |= next ^ mid[x];
+    }
+    return diff != 0;
+}
+
+#ifdef AUTOMATA_X86
+
+AUTOMATA_TARGET("sse2")
+bool row_sse2(const uint8_t *up, const uint8_t *mid, const uint8_t *down, uint8_t *out, int begin, int end, const RuleTables &t) {
+    // SSE2 has no byte shuffle, so match each count that appears in the rule instead.
+    int terms = 0;
+    uint8_t term_count[9];
+    uint8_t term_birth[9];
+    uint8_t term_survive[9];
+    for (int n = 0; n < 9; n++) {
+        if (t.birth[n] | t.survive[n]) {
+            term_count[terms] = static_cast<uint8_t>(n);
+            term_birth[terms] = t.birth[n] ? 0xFF : 0;
+            term_survive[terms] = t.survive[n] ? 0xFF : 0;
+            terms++;
+        }
+    }
+
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i diff = _mm_setzero_si128();
+    int x = begin;
+    for (; x + 16 <= end; x += 16) {
+        __m128i n = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(up + x - 1)), _mm_loadu_si128(reinterpret_cast<const __m128i *>(up + x)));
+        n = _mm_add_epi8(n, _mm_loadu_si128(reinterpret_cast<const __m128i *>(up + x + 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128(reinterpret_cast<const __m128i *>(mid + x - 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128(reinterpret_cast<const __m128i *>(mid + x + 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128(reinterpret_cast<const __m128i *>(down + x - 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128(reinterpret_cast<const __m128i *>(down + x)));
+        n = _mm_add_epi8(n, _mm_loadu_si128(reinterpret_cast<const __m128i *>(down + x + 1)));
+
+        const __m128i center = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mid + x));
+        const __m128i alive = _mm_cmpeq_epi8(center, one);
+        __m128i next = _mm_setzero_si128();
+        for (int i = 0; i < terms; i++) {
+            const __m128i eq = _mm_cmpeq_epi8(n, _mm_set1_epi8(static_cast<char>(term_count[i])));
+            const __m128i select = _mm_or_si128(_mm_and_si128(alive, _mm_set1_epi8(static_cast<char>(term_survive[i]))),
+                    _mm_andnot_si128(alive, _mm_set1_epi8(static_cast<char>(term_birth[i]))));
+            next = _mm_or_si128(next, _mm_and_si128(eq, select));
+        }
+        next = _mm_and_si128(next, one);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), next);
+        diff = _mm_or_si128(diff, _mm_xor_si128(next, center));
+    }
+    const bool tail_changed = row_scalar(up, mid, down, out, x, end, t);
+    return tail_changed || _mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xFFFF;
+}
+
+// Same compare chain with the rule's counts known at compile time, so it unrolls to the few
+// counts the rule uses.
+template <uint16_t BIRTH, uint16_t SURVIVE>
+AUTOMATA_TARGET("sse2")
+bool row_sse2_fixed(const uint8_t *up, const uint8_t *mid, const uint8_t *down, uint8_t *out, int begin, int end, const RuleTables &t) {
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i diff = _mm_setzero_si128();
+    int x = begin;
+    for (; x + 16 <= end; x += 16) {
+        __m128i n = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(up + x - 1)), _mm_loadu_si128(reinterpret_cast<const __m128i *>(up + x)));
+        n = _mm_add_epi8(n, _mm_loadu_si128(reinterpret_cast<const __m128i *>(up + x + 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128(reinterpret_cast<const __m128i *>(mid + x - 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128(reinterpret_cast<const __m128i *>(mid + x + 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128(reinterpret_cast<const __m128i *>(down + x - 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128(reinterpret_cast<const __m128i *>(down + x)));
+        n = _mm_add_epi8(n, _mm_loadu_si128(reinterpret_cast<const __m128i *>(down + x + 1)));
+
+        const __m128i center = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mid + x));
+        const __m128i alive = _mm_cmpeq_epi8(center, one);
+        __m128i born = _mm_setzero_si128();
+        __m128i survives = _mm_setzero_si128();
+        for (int count = 0; count <= 8; count++) {
+            if (!(((BIRTH | SURVIVE) >> count) & 1)) {
+                continue;
+            }
+            const __m128i eq = _mm_cmpeq_epi8(n, _mm_set1_epi8(static_cast<char>(count)));
+            if ((BIRTH >> count) & 1) {
+                born = _mm_or_si128(born, eq);
+            }
+            if ((SURVIVE >> count) & 1) {
+                survives = _mm_or_si128(survives, eq);
+            }
+        }
+        __m128i next = _mm_or_si128(_mm_and_si128(alive, survives), _mm_andnot_si128(alive, born));
+        next = _mm_and_si128(next, one);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), next);
+        diff = _mm_or_si128(diff, _mm_xor_si128(next, center));
+    }
+    const bool tail_changed = row_fixed<BIRTH, SURVIVE>(up, mid, down, out, x, end, t);
+    return tail_changed || _mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xFFFF;
+}
+
+AUTOMATA_TARGET("avx2")
+bool row_avx2(const uint8_t *up, const uint8_t *mid, const uint8_t *down, uint8_t *out, int begin, int end, const RuleTables &t) {
+    const __m256i birth = _mm256_load_si256(reinterpret_cast<const __m256i *>(t.birth));
+    const __m256i survive = _mm256_load_si256(reinterpret_cast<const __m256i *>(t.survive));
+    const __m256i one = _mm256_set1_epi8(1);
+    __m256i diff = _mm256_setzero_si256();
+    int x = begin;
+    for (; x + 32 <= end; x += 32) {
+        __m256i n = _mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(up + x - 1)), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(up + x)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(up + x + 1)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(mid + x - 1)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(mid + x + 1)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(down + x - 1)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(down + x)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(down + x + 1)));
+
+        const __m256i center = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(mid + x));
+        const __m256i alive = _mm256_cmpeq_epi8(center, one);
+        const __m256i next = _mm256_blendv_epi8(_mm256_shuffle_epi8(birth, n), _mm256_shuffle_epi8(survive, n), alive);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x), next);
+        diff = _mm256_or_si256(diff, _mm256_xor_si256(next, center));
+    }
+    const bool tail_changed = row_scalar(up, mid, down, out, x, end, t);
+    return tail_changed || !_mm256_testz_si256(diff, diff);
+}
+
+AUTOMATA_TARGET("avx512f,avx512bw")
+bool row_avx512(const uint8_t *up, const uint8_t *mid, const uint8_t *down, uint8_t *out, int begin, int end, const RuleTables &t) {
+    const __m512i birth = _mm512_load_si512(t.birth);
+    const __m512i survive = _mm512_load_si512(t.survive);
+    const __m512i one = _mm512_set1_epi8(1);
+    __mmask64 diff = 0;
+    int x = begin;
+    for (; x + 64 <= end; x += 64) {
+        __m512i n = _mm512_add_epi8(_mm512_loadu_si512(up + x - 1), _mm512_loadu_si512(up + x));
+        n = _mm512_add_epi8(n, _mm512_loadu_si512(up + x + 1));
+        n = _mm512_add_epi8(n, _mm512_loadu_si512(mid + x - 1));
+        n = _mm512_add_epi8(n, _mm512_loadu_si512(mid + x + 1));
+        n = _mm512_add_epi8(n, _mm512_loadu_si512(down + x - 1));
+        n = _mm512_add_epi8(n, _mm512_loadu_si512(down + x));
+        n = _mm512_add_epi8(n, _mm512_loadu_si512(down + x + 1));
+
+        const __m512i center = _mm512_loadu_si512(mid + x);
+        const __mmask64 alive = _mm512_cmpeq_epi8_mask(center, one);
+        const __m512i next = _mm512_mask_blend_epi8(alive, _mm512_shuffle_epi8(birth, n), _mm512_shuffle_epi8(survive, n));
+        _mm512_storeu_si512(out + x, next);
+        diff |= _mm512_cmpneq_epi8_mask(next, center);
+    }
+    const bool tail_changed = row_avx2(up, mid, down, out, x, end, t);
+    return tail_changed || diff != 0;
+}
+
+void cpuid(int leaf, int subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+    int out[4];
+    __cpuidex(out, leaf, subleaf);
+    for (int i = 0; i < 4; i++) {
+        regs[i] = static_cast<uint32_t>(out[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+uint64_t read_xcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+SimdLevel probe_simd_level() {
+    uint32_t regs[4];
+    cpuid(0, 0, regs);
+    const uint32_t max_leaf = regs[0];
+    if (max_leaf < 1) {
+        return SIMD_SCALAR;
+    }
+
+    cpuid(1, 0, regs);
+    const bool sse2 = (regs[3] >> 26) & 1;
+    const bool osxsave = (regs[2] >> 27) & 1;
+    const bool avx = (regs[2] >> 28) & 1;
+    if (!sse2) {
+        return SIMD_SCALAR;
+    }
+    if (!osxsave || !avx || max_leaf < 7) {
+        return SIMD_SSE2;
+    }
+
+    // The OS must save YMM (and for AVX-512, opmask + ZMM) state across context switches.
+    const uint64_t xcr0 = read_xcr0();
+    if ((xcr0 & 0x6) != 0x6) {
+        return SIMD_SSE2;
+    }
+    cpuid(7, 0, regs);
+    const bool avx2 = (regs[1] >> 5) & 1;
+    const bool avx512f = (regs[1] >> 16) & 1;
+    const bool avx512bw = (regs[1] >> 30) & 1;
+    if (!avx2) {
+        return SIMD_SSE2;
+    }
+    if (avx512f && avx512bw && (xcr0 & 0xE6) == 0xE6) {
+        return SIMD_AVX512;
+    }
+    return SIMD_AVX2;
+}
+
+#else
+
+SimdLevel probe_simd_level() {
+    return SIMD_SCALAR;
+}
+
+#endif // AUTOMATA_X86
+
+const SimdLevel detected_level = probe_simd_level();
+std::atomic<int> level_limit{ SIMD_AVX512 };
+
+template <uint16_t BIRTH, uint16_t SURVIVE>
+RowKernel select_fixed_kernel(SimdLevel level) {
+    switch (level) {
+#ifdef AUTOMATA_X86
+        case SIMD_AVX512:
+            return row_avx512;
+        case SIMD_AVX2:
+            return row_avx2;
+        case SIMD_SSE2:
+            return row_sse2_fixed<BIRTH, SURVIVE>;
+#endif
+        default:
+            return row_fixed<BIRTH, SURVIVE>;
+    }
+}
+
+// The byte shuffles in the AVX2 / AVX-512 kernels cost the same for every rule, so only the
+// SSE2 and scalar levels have per-rule instantiations.
+RowKernel select_kernel(SimdLevel level, BuiltinRule rule) {
+    switch (rule) {
+        case RULE_LIFE:
+            return select_fixed_kernel<LIFE_BIRTH, LIFE_SURVIVE>(level);
+        case RULE_DAY_NIGHT:
+            return select_fixed_kernel<DAY_NIGHT_BIRTH, DAY_NIGHT_SURVIVE>(level);
+        case RULE_SEEDS:
+            return select_fixed_kernel<SEEDS_BIRTH, SEEDS_SURVIVE>(level);
+        default:
+            break;
+    }
+    switch (level) {
+#ifdef AUTOMATA_X86
+        case SIMD_AVX512:
+            return row_avx512;
+        case SIMD_AVX2:
+            return row_avx2;
+        case SIMD_SSE2:
+            return row_sse2;
+#endif
+        default:
+            return row_lut512;
+    }
+}
+
+// Value of the virtual cell at column x (x may be -1 or width) for the given edge mode.
+template <int EDGE>
+inline uint8_t edge_sample(const uint8_t *row, int x, int width) {
+    if (x >= 0 && x < width) {
+        return row[x];
+    }
+    if constexpr (EDGE == EDGE_WRAP) {
+        return row[wrap_axis(x, width)];
+    } else if constexpr (EDGE == EDGE_BOUNCE) {
+        return row[clamp_axis(x, width)];
+    } else {
+        return 0;
+    }
+}
+
+template <int EDGE>
+inline bool step_edge_column(const uint8_t *up, const uint8_t *mid, const uint8_t *down, uint8_t *out, int x, int width, const RuleTables &t) {
+    const int n = edge_sample<EDGE>(up, x - 1, width) + up[x] + edge_sample<EDGE>(up, x + 1, width) +
+                  edge_sample<EDGE>(mid, x - 1, width) + edge_sample<EDGE>(mid, x + 1, width) +
+                  edge_sample<EDGE>(down, x - 1, width) + down[x] + edge_sample<EDGE>(down, x + 1, width);
+    const uint8_t next = mid[x] == 1 ? t.survive[n] : t.birth[n];
+    out[x] = next;
+    return next != mid[x];
+}
+
+template <int EDGE>
+bool step_block(const uint8_t *src, uint8_t *dst, int width, int height, int row_begin, int row_end, int col_begin, int col_end, RowKernel kernel, const RuleTables &tables) {
+    static thread_local std::vector<uint8_t> zero_cells;
+    if (zero_cells.size() < static_cast<size_t>(width)) {
+        zero_cells.assign(width, 0);
+    }
+    const uint8_t *zero_row = zero_cells.data();
+
+    bool changed = false;
+    for (int y = row_begin; y < row_end; y++) {
+        const uint8_t *up;
+        const uint8_t *down;
+        if constexpr (EDGE == EDGE_WRAP) {
+            up = src + static_cast<int64_t>(wrap_axis(y - 1, height)) * width;
+            down = src + static_cast<int64_t>(wrap_axis(y + 1, height)) * width;
+        } else if constexpr (EDGE == EDGE_BOUNCE) {
+            up = src + static_cast<int64_t>(clamp_axis(y - 1, height)) * width;
+            down = src + static_cast<int64_t>(clamp_axis(y + 1, height)) * width;
+        } else {
+            up = y > 0 ? src + static_cast<int64_t>(y - 1) * width : zero_row;
+            down = y + 1 < height ? src + static_cast<int64_t>(y + 1) * width : zero_row;
+        }
+        const uint8_t *mid = src + static_cast<int64_t>(y) * width;
+        uint8_t *out = dst + static_cast<int64_t>(y) * width;
+
+        if (col_begin == 0) {
+            changed |= step_edge_column<EDGE>(up, mid, down, out, 0, width, tables);
+        }
+        if (col_end == width && width > 1) {
+            changed |= step_edge_column<EDGE>(up, mid, down, out, width - 1, width, tables);
+        }
+        const int inner_begin = std::max(col_begin, 1);
+        const int inner_end = std::min(col_end, width - 1);
+        if (inner_begin < inner_end) {
+            changed |= kernel(up, mid, down, out, inner_begin, inner_end, tables);
+        }
+    }
+    return changed;
+}
+
+} // namespace
+
+SimdLevel detected_simd_level() {
+    return detected_level;
+}
+
+SimdLevel active_simd_level() {
+    const int limit = level_limit.load(std::memory_order_relaxed);
+    return static_cast<SimdLevel>(limit < detected_level ? limit : detected_level);
+}
+
+void set_simd_level_limit(int level) {
+    level_limit.store(std::clamp(level, static_cast<int>(SIMD_SCALAR), static_cast<int>(SIMD_AVX512)), std::memory_order_relaxed);
+}
+
+const char *simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SIMD_SSE2:
+            return "sse2";
+        case SIMD_AVX2:
+            return "avx2";
+        case SIMD_AVX512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
+
+bool step_bytes_rows(const uint8_t *src, uint8_t *dst, int width, int height, int row_begin, int row_end, int edge_mode, uint16_t birth_mask, uint16_t survive_mask) {
+    return step_bytes_block(src, dst, width, height, row_begin, row_end, 0, width, edge_mode, birth_mask, survive_mask);
+}
+
+bool step_bytes_block(const uint8_t *src, uint8_t *dst, int width, int height, int row_begin, int row_end, int col_begin, int col_end, int edge_mode, uint16_t birth_mask, uint16_t survive_mask) {
+    const RowKernel kernel = select_kernel(active_simd_level(), builtin_rule(birth_mask, survive_mask));
+    const RuleTables &tables = rule_tables(birth_mask, survive_mask, kernel == row_lut512);
+
+    switch (edge_mode) {
+        case EDGE_WRAP:
+            return step_block<EDGE_WRAP>(src, dst, width, height, row_begin, row_end, col_begin, col_end, kernel, tables);
+        case EDGE_BOUNCE:
+            return step_block<EDGE_BOUNCE>(src, dst, width, height, row_begin, row_end, col_begin, col_end, kernel, tables);
+        default:
+            return step_block<EDGE_FALLOFF>(src, dst, width, height, row_begin, row_end, col_begin, col_end, kernel, tables);
+    }
+}
+
+} // namespace automata
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "automata_common.h"
+
+#include <cstdint>
+
+// Byte-grid (one cell per byte, 0/1) totalistic stepping with vectorized row kernels.
+//
+// Interior columns run through an SSE2 / AVX2 / AVX-512BW kernel picked from CPUID when the
+// library loads; the two edge columns and row selection are resolved once per row in scalar
+// code, so the hot loop never touches the edge mode. Non-x86 builds use the scalar kernel.
+// B3/S23, B3678/S34678 and B2/S have compile-time kernels at the SSE2 and scalar levels; other
+// scalar rules go through a 512-entry table indexed by the whole 3x3 neighborhood.
+
+namespace automata {
+
+enum SimdLevel {
+    SIMD_SCALAR = 0,
+    SIMD_SSE2 = 1,
+    SIMD_AVX2 = 2,
+    SIMD_AVX512 = 3,
+};
+
+// Best level supported by this CPU and OS (probed once).
+SimdLevel detected_simd_level();
+
+// Level currently used by the byte kernels: the detected level capped by `set_simd_level_limit`.
+SimdLevel active_simd_level();
+
+// Caps the kernels at `level` (clamped to what the CPU supports). Used to compare ISAs.
+void set_simd_level_limit(int level);
+
+const char *simd_level_name(SimdLevel level);
+
+// Advances rows [row_begin, row_end) of a byte grid by one generation. `src` and `dst` must not
+// alias. Birth / survive masks use bit n for "n live neighbors". Returns true when any cell changed.
+bool step_bytes_rows(const uint8_t *src, uint8_t *dst, int width, int height, int row_begin, int row_end, int edge_mode, uint16_t birth_mask, uint16_t survive_mask);
+
+// Same as step_bytes_rows but only writes columns [col_begin, col_end) of each row.
+bool step_bytes_block(const uint8_t *src, uint8_t *dst, int width, int height, int row_begin, int row_end, int col_begin, int col_end, int edge_mode, uint16_t birth_mask, uint16_t survive_mask);
+
+} // namespace automata
@@ -0,0 +1,89 @@
+#include "totalistic_temporal.h"
+
+#include "totalistic_simd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace automata {
+
+namespace {
+
+// Generations advanced per tile visit; deeper blocks save bandwidth but recompute more halo.
+constexpr int MAX_BLOCK_GENERATIONS = 8;
+// Target size of one tile buffer (two are live per thread), comfortably inside a 512 KiB L2.
+constexpr int64_t TILE_BYTES = 192 * 1024;
+
+void step_tile(const uint8_t *src, uint8_t *dst, int width, int height, int core_begin, int core_end, int generations, int edge_mode, uint16_t birth_mask, uint16_t survive_mask) {
+    // Virtual rows [first, last) of the tile; wrap mode unrolls the torus so the halo never clips.
+    int first = core_begin - generations;
+    int last = core_end + generations;
+    bool top_real = false;
+    bool bottom_real = false;
+    if (edge_mode != EDGE_WRAP) {
+        top_real = first <= 0;
+        bottom_real = last >= height;
+        first = std::max(first, 0);
+        last = std::min(last, height);
+    }
+    const int rows = last - first;
+    const size_t bytes = static_cast<size_t>(rows) * width;
+
+    static thread_local std::vector<uint8_t> front;
+    static thread_local std::vector<uint8_t> back;
+    if (front.size() < bytes) {
+        front.resize(bytes);
+        back.resize(bytes);
+    }
+    uint8_t *cur = front.data();
+    uint8_t *next = back.data();
+
+    for (int r = 0; r < rows; r++) {
+        const int y = edge_mode == EDGE_WRAP ? wrap_axis(first + r, height) : first + r;
+        memcpy(cur + static_cast<size_t>(r) * width, src + static_cast<int64_t>(y) * width, width);
+    }
+
+    for (int g = 1; g <= generations; g++) {
+        // Rows next to a halo edge lose validity each generation, so skip them (the trapezoid).
+        const int begin = top_real ? 0 : g;
+        const int end = bottom_real ? rows : rows - g;
+        step_bytes_rows(cur, next, width, rows, begin, end, edge_mode, birth_mask, survive_mask);
+        std::swap(cur, next);
+    }
+
+    const int offset = core_begin - first;
+    memcpy(dst + static_cast<int64_t>(core_begin) * width, cur + static_cast<size_t>(offset) * width, static_cast<size_t>(core_end - core_begin) * width);
+}
+
+} // namespace
+
+bool step_bytes_generations(const uint8_t *src, uint8_t *dst, uint8_t *scratch, int width, int height, int edge_mode, uint16_t birth_mask, uint16_t survive_mask, int generations, WorkerPool &pool) {
+    const size_t grid_bytes = static_cast<size_t>(width) * height;
+    if (generations <= 0) {
+        memcpy(dst, src, grid_bytes);
+        return false;
+    }
+
+    // Alternate between dst and scratch so that the final block lands in dst.
+    const int blocks = (generations + MAX_BLOCK_GENERATIONS - 1) / MAX_BLOCK_GENERATIONS;
+    const uint8_t *from = src;
+    uint8_t *to = (blocks & 1) ? dst : scratch;
+    int remaining = generations;
+    while (remaining > 0) {
+        const int block = std::min(remaining, MAX_BLOCK_GENERATIONS);
+        const int tile_rows = static_cast<int>(std::max<int64_t>(2 * block, TILE_BYTES / width));
+        const int tiles = (height + tile_rows - 1) / tile_rows;
+        pool.run(static_cast<uint32_t>(tiles), [&](uint32_t i) {
+            const int core_begin = static_cast<int>(i) * tile_rows;
+            const int core_end = std::min(height, core_begin + tile_rows);
+            step_tile(from, to, width, height, core_begin, core_end, block, edge_mode, birth_mask, survive_mask);
+        });
+        remaining -= block;
+        from = to;
+        to = to == dst ? scratch : dst;
+    }
+    return memcmp(src, dst, grid_bytes) != 0;
+}
+
+} // namespace automata
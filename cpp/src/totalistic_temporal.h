@@ -0,0 +1,20 @@
+#pragma once
+
+#include "worker_pool.h"
+
+#include <cstdint>
+
+// Multi-generation stepping for byte grids with temporal cache blocking.
+//
+// The grid is cut into full-width row tiles sized to stay in L2. Each tile is copied with a halo
+// of k rows above and below, advanced k generations in a private buffer while the valid region
+// shrinks by one row per side per generation (a trapezoid), and only its core rows are written
+// back. Tiles at a real grid edge (bounce / falloff) apply the edge mode instead of a halo.
+
+namespace automata {
+
+// Advances `src` by `generations` generations into `dst`; `scratch` is a second grid-sized buffer.
+// None of the three may alias. Returns true when the result differs from `src`.
+bool step_bytes_generations(const uint8_t *src, uint8_t *dst, uint8_t *scratch, int width, int height, int edge_mode, uint16_t birth_mask, uint16_t survive_mask, int generations, WorkerPool &pool);
+
+} // namespace automata
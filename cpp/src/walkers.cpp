@@ -0,0 +1,119 @@
+#include "walkers.h"
+
+#include "automata_common.h"
+
+namespace automata {
+
+namespace {
+
+constexpr int32_t DIR_X[4] = { 0, 1, 0, -1 };
+constexpr int32_t DIR_Y[4] = { -1, 0, 1, 0 };
+
+} // namespace
+
+void WalkerStore::clear() {
+    truncate(0);
+}
+
+void WalkerStore::reserve(size_t count) {
+    xs.reserve(count);
+    ys.reserve(count);
+    dirs.reserve(count);
+    palette.reserve(count);
+}
+
+void WalkerStore::add(int32_t x, int32_t y, int dir, uint8_t color) {
+    xs.push_back(x);
+    ys.push_back(y);
+    dirs.push_back(static_cast<uint8_t>(dir & 3));
+    palette.push_back(color);
+}
+
+size_t WalkerStore::remove_in_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    const size_t count = xs.size();
+    size_t out = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (xs[i] >= x0 && xs[i] < x1 && ys[i] >= y0 && ys[i] < y1) {
+            continue;
+        }
+        xs[out] = xs[i];
+        ys[out] = ys[i];
+        dirs[out] = dirs[i];
+        palette[out] = palette[i];
+        out++;
+    }
+    truncate(out);
+    return count - out;
+}
+
+bool WalkerStore::any_at(int32_t x, int32_t y) const {
+    for (size_t i = 0; i < xs.size(); i++) {
+        if (xs[i] == x && ys[i] == y) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WalkerStore::wrap(int32_t width, int32_t height) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    for (size_t i = 0; i < xs.size(); i++) {
+        xs[i] = wrap_axis(xs[i], width);
+        ys[i] = wrap_axis(ys[i], height);
+    }
+}
+
+WalkerStep WalkerStore::step(uint8_t *cells, int32_t width, int32_t height, int edge_mode, const bool turns[2]) {
+    WalkerStep result;
+    const size_t count = xs.size();
+    size_t out = 0;
+    for (size_t i = 0; i < count; i++) {
+        const int32_t x = xs[i];
+        const int32_t y = ys[i];
+        if (x < 0 || x >= width || y < 0 || y >= height) {
+            continue;
+        }
+
+        uint8_t &cell = cells[static_cast<size_t>(y) * width + x];
+        const int current = cell != 0;
+        int dir = turns[current] ? (dirs[i] + 1) & 3 : (dirs[i] + 3) & 3;
+        cell = static_cast<uint8_t>(1 - current);
+
+        int32_t nx = x + DIR_X[dir];
+        int32_t ny = y + DIR_Y[dir];
+        if (nx < 0 || nx >= width || ny < 0 || ny >= height) {
+            if (edge_mode == EDGE_WRAP) {
+                nx = wrap_axis(nx, width);
+                ny = wrap_axis(ny, height);
+            } else if (edge_mode == EDGE_BOUNCE) {
+                dir = (dir + 2) & 3;
+                nx = clamp_axis(x + DIR_X[dir], width);
+                ny = clamp_axis(y + DIR_Y[dir], height);
+            } else {
+                continue; // falls off
+            }
+        }
+
+        xs[out] = nx;
+        ys[out] = ny;
+        dirs[out] = static_cast<uint8_t>(dir);
+        palette[out] = palette[i];
+        out++;
+    }
+    truncate(out);
+    result.removed = count - out;
+    // Every walker that moved flipped its cell.
+    result.changed = count > 0;
+    return result;
+}
+
+void WalkerStore::truncate(size_t count) {
+    xs.resize(count);
+    ys.resize(count);
+    dirs.resize(count);
+    palette.resize(count);
+}
+
+} // namespace automata
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace automata {
+
+struct WalkerStep {
+    bool changed = false;
+    // Walkers that started off the grid or fell off it this step.
+    size_t removed = 0;
+};
+
+// Ants and turmites on a dense grid, stored as parallel arrays so a step streams through four
+// flat buffers instead of boxing every walker. Directions are 0 up, 1 right, 2 down, 3 left, like
+// the other steppers; `palette` is an index into a colour table kept by the caller. Removal is
+// stable: walkers keep their order, which decides who moves first when two share a cell.
+class WalkerStore {
+public:
+    void clear();
+    void reserve(size_t count);
+    size_t size() const { return xs.size(); }
+    bool empty() const { return xs.empty(); }
+
+    void add(int32_t x, int32_t y, int dir, uint8_t color);
+    // Walkers inside [x0, x1) x [y0, y1); returns how many were removed.
+    size_t remove_in_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+    bool any_at(int32_t x, int32_t y) const;
+    // Folds every position back into a width x height grid (after a resize).
+    void wrap(int32_t width, int32_t height);
+
+    // One move per walker: turn right when turns[state] is set (left otherwise), flip the cell and
+    // step forward under `edge_mode`. Ants use turns = { false, true }.
+    WalkerStep step(uint8_t *cells, int32_t width, int32_t height, int edge_mode, const bool turns[2]);
+
+    const int32_t *get_x() const { return xs.data(); }
+    const int32_t *get_y() const { return ys.data(); }
+    const uint8_t *get_dirs() const { return dirs.data(); }
+    const uint8_t *get_palette() const { return palette.data(); }
+
+private:
+    void truncate(size_t count);
+
+    std::vector<int32_t> xs;
+    std::vector<int32_t> ys;
+    std::vector<uint8_t> dirs;
+    std::vector<uint8_t> palette;
+};
+
+} // namespace automata
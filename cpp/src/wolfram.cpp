@@ -0,0 +1,242 @@
+#include "wolfram.h"
+
+#include "totalistic_bits.h"
+
+#include <utility>
+#include <vector>
+
+namespace automata {
+
+namespace {
+
+// The rule as a mux tree over the neighborhood key (left << 2 | center << 1 | right). Each rule bit
+// becomes a 0 / all-ones mask, and pairs store the base mask and its difference to the other leaf,
+// so a mux on a selector word is one AND and one XOR.
+struct WolframMasks {
+    uint64_t base[4];
+    uint64_t diff[4];
+
+    explicit WolframMasks(int rule) {
+        for (int i = 0; i < 4; i++) {
+            const uint64_t low = 0ULL - static_cast<uint64_t>((rule >> (2 * i)) & 1);
+            const uint64_t high = 0ULL - static_cast<uint64_t>((rule >> (2 * i + 1)) & 1);
+            base[i] = low;
+            diff[i] = low ^ high;
+        }
+    }
+
+    uint64_t apply(uint64_t left, uint64_t center, uint64_t right) const {
+        const uint64_t c0 = base[0] ^ (diff[0] & right);
+        const uint64_t c1 = base[1] ^ (diff[1] & right);
+        const uint64_t c2 = base[2] ^ (diff[2] & right);
+        const uint64_t c3 = base[3] ^ (diff[3] & right);
+        const uint64_t l0 = c0 ^ ((c0 ^ c1) & center);
+        const uint64_t l1 = c2 ^ ((c2 ^ c3) & center);
+        return l0 ^ ((l0 ^ l1) & left);
+    }
+};
+
+// Cell state under all 256 rules: bit b of word j is rule 64 * j + b.
+struct RuleLanes {
+    uint64_t words[4];
+};
+
+// WolframMasks across rules: lane r of mask k holds bit k of rule r.
+struct AtlasMasks {
+    RuleLanes base[4];
+    RuleLanes diff[4];
+
+    AtlasMasks() {
+        RuleLanes bit[8];
+        for (int k = 0; k < 8; k++) {
+            for (int j = 0; j < 4; j++) {
+                uint64_t word = 0;
+                for (int b = 0; b < 64; b++) {
+                    word |= static_cast<uint64_t>(((64 * j + b) >> k) & 1) << b;
+                }
+                bit[k].words[j] = word;
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                base[i].words[j] = bit[2 * i].words[j];
+                diff[i].words[j] = bit[2 * i].words[j] ^ bit[2 * i + 1].words[j];
+            }
+        }
+    }
+};
+
+void step_atlas_row(const RuleLanes *source, RuleLanes *out, int width, int edge_mode, const AtlasMasks &masks) {
+    RuleLanes ghost_left = {};
+    RuleLanes ghost_right = {};
+    if (edge_mode == EDGE_WRAP) {
+        ghost_left = source[width - 1];
+        ghost_right = source[0];
+    } else if (edge_mode == EDGE_BOUNCE) {
+        ghost_left = source[0];
+        ghost_right = source[width - 1];
+    }
+    for (int x = 0; x < width; x++) {
+        const RuleLanes &left = x > 0 ? source[x - 1] : ghost_left;
+        const RuleLanes &right = x + 1 < width ? source[x + 1] : ghost_right;
+        for (int j = 0; j < 4; j++) {
+            const uint64_t c0 = masks.base[0].words[j] ^ (masks.diff[0].words[j] & right.words[j]);
+            const uint64_t c1 = masks.base[1].words[j] ^ (masks.diff[1].words[j] & right.words[j]);
+            const uint64_t c2 = masks.base[2].words[j] ^ (masks.diff[2].words[j] & right.words[j]);
+            const uint64_t c3 = masks.base[3].words[j] ^ (masks.diff[3].words[j] & right.words[j]);
+            const uint64_t l0 = c0 ^ ((c0 ^ c1) & source[x].words[j]);
+            const uint64_t l1 = c2 ^ ((c2 ^ c3) & source[x].words[j]);
+            out[x].words[j] = l0 ^ ((l0 ^ l1) & left.words[j]);
+        }
+    }
+}
+
+// In-place transpose of a 64 x 64 bit matrix: bit b of word i moves to bit i of word b.
+void transpose_bits64(uint64_t *rows) {
+    uint64_t mask = 0x00000000FFFFFFFFULL;
+    for (int shift = 32; shift != 0; shift >>= 1, mask ^= mask << shift) {
+        for (int k = 0; k < 64; k = ((k | shift) + 1) & ~shift) {
+            const uint64_t swap = ((rows[k] >> shift) ^ rows[k | shift]) & mask;
+            rows[k] ^= swap << shift;
+            rows[k | shift] ^= swap;
+        }
+    }
+}
+
+int packed_bit(const uint64_t *row, int x) {
+    return static_cast<int>((row[x >> 6] >> (x & 63)) & 1ULL);
+}
+
+} // namespace
+
+void step_wolfram_bits(const uint64_t *source, uint64_t *out, int width, int rule, int edge_mode) {
+    if (width <= 0) {
+        return;
+    }
+    const WolframMasks masks(rule & 0xff);
+    const int words = words_per_row(width);
+    const int tail = width & 63;
+
+    // Ghost cells at x = -1 and x = width.
+    uint64_t ghost_left = 0;
+    uint64_t ghost_right = 0;
+    if (edge_mode == EDGE_WRAP) {
+        ghost_left = static_cast<uint64_t>(packed_bit(source, width - 1));
+        ghost_right = static_cast<uint64_t>(packed_bit(source, 0));
+    } else if (edge_mode == EDGE_BOUNCE) {
+        ghost_left = static_cast<uint64_t>(packed_bit(source, 0));
+        ghost_right = static_cast<uint64_t>(packed_bit(source, width - 1));
+    }
+
+    // The last word carries the right ghost in its first padding bit, or passes it on as the
+    // next word's bit 0 when the row fills the word exactly.
+    const uint64_t last = tail == 0 ? source[words - 1] : source[words - 1] | (ghost_right << tail);
+    const uint64_t after_last = tail == 0 ? ghost_right : 0;
+
+    uint64_t prev = ghost_left << 63;
+    for (int w = 0; w < words - 1; w++) {
+        const uint64_t center = source[w];
+        const uint64_t next = source[w + 1];
+        out[w] = masks.apply((center << 1) | (prev >> 63), center, (center >> 1) | (next << 63));
+        prev = center;
+    }
+    const uint64_t center = last;
+    out[words - 1] = masks.apply((center << 1) | (prev >> 63), center, (center >> 1) | (after_last << 63)) & last_word_mask(width);
+}
+
+int64_t step_wolfram_rows(uint8_t *cells, int width, int height, int rule, int start_row, int64_t count, int edge_mode, bool allow_wrap,
+        WolframProgress *progress) {
+    if (width <= 0 || height <= 0 || count <= 0) {
+        return 0;
+    }
+    int row = allow_wrap ? wrap_axis(start_row, height) : start_row;
+    if (row < 0 || row >= height) {
+        return 0;
+    }
+    const int source_row = row > 0 ? row - 1 : (allow_wrap ? height - 1 : 0);
+
+    static thread_local std::vector<uint64_t> packed;
+    const size_t words = static_cast<size_t>(words_per_row(width));
+    packed.resize(words * 2);
+    uint64_t *previous = packed.data();
+    uint64_t *next = packed.data() + words;
+    pack_rows(cells + static_cast<int64_t>(source_row) * width, width, 1, previous);
+
+    int64_t written = 0;
+    while (written < count) {
+        if (progress != nullptr && progress->cancel.load(std::memory_order_relaxed)) {
+            break;
+        }
+        step_wolfram_bits(previous, next, width, rule, edge_mode);
+        unpack_rows(next, width, 1, cells + static_cast<int64_t>(row) * width);
+        std::swap(previous, next);
+        written++;
+        if (progress != nullptr) {
+            progress->rows.store(written, std::memory_order_relaxed);
+        }
+        if (++row == height) {
+            if (!allow_wrap) {
+                break;
+            }
+            row = 0;
+        }
+    }
+    return written;
+}
+
+void step_wolfram_row(const uint8_t *source, uint8_t *out, int width, int rule, int edge_mode) {
+    static thread_local std::vector<uint64_t> packed;
+    const size_t words = static_cast<size_t>(words_per_row(width));
+    packed.resize(words * 2);
+    pack_rows(source, width, 1, packed.data());
+    step_wolfram_bits(packed.data(), packed.data() + words, width, rule, edge_mode);
+    unpack_rows(packed.data() + words, width, 1, out);
+}
+
+void build_wolfram_atlas(const uint8_t *seed, int width, int rows, int edge_mode, uint8_t *out) {
+    if (width <= 0 || rows <= 0) {
+        return;
+    }
+    static const AtlasMasks masks;
+    const int64_t atlas_width = static_cast<int64_t>(width) * WOLFRAM_ATLAS_COLUMNS;
+
+    std::vector<RuleLanes> current(static_cast<size_t>(width));
+    std::vector<RuleLanes> next(static_cast<size_t>(width));
+    for (int x = 0; x < width; x++) {
+        const uint64_t alive = seed[x] != 0 ? ~0ULL : 0ULL;
+        current[x] = RuleLanes{ { alive, alive, alive, alive } };
+    }
+
+    // Each 64-cell block of one lane word is transposed so that every rule's cells form one word,
+    // which unpacks straight into that rule's tile row.
+    uint64_t block[64];
+    for (int y = 0; y < rows; y++) {
+        if (y > 0) {
+            step_atlas_row(current.data(), next.data(), width, edge_mode, masks);
+            current.swap(next);
+        }
+        for (int base = 0; base < width; base += 64) {
+            const int count = width - base < 64 ? width - base : 64;
+            for (int j = 0; j < 4; j++) {
+                for (int i = 0; i < 64; i++) {
+                    block[i] = i < count ? current[base + i].words[j] : 0;
+                }
+                transpose_bits64(block);
+                for (int b = 0; b < 64; b++) {
+                    const int rule = 64 * j + b;
+                    const int64_t tile_row = static_cast<int64_t>(rule / WOLFRAM_ATLAS_COLUMNS) * rows + y;
+                    uint8_t *dst = out + tile_row * atlas_width + static_cast<int64_t>(rule % WOLFRAM_ATLAS_COLUMNS) * width + base;
+                    if (count == 64) {
+                        for (int i = 0; i < 64; i += 8) {
+                            unpack_byte_lanes(block[b] >> i, dst + i);
+                        }
+                    } else {
+                        unpack_rows(&block[b], count, 1, dst);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace automata
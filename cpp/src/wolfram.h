@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Elementary (Wolfram) cellular automaton rows on a byte grid.
+//
+// Rows are stepped bit-sliced: the row is packed into 64-bit words (totalistic_bits.h layout),
+// the left and right neighbors of 64 cells are one shift each, and the rule is evaluated as a
+// mux tree over (left, center, right) with the eight rule bits as all-ones / all-zero masks.
+// Edge modes only touch the ghost bits fed into the first and last word.
+
+namespace automata {
+
+// Writes the successor of `source` (width 0/1 bytes) into `out` under the 8-bit `rule`. Cells
+// past either end come from the edge mode. The row is packed before anything is written, so
+// `source` and `out` may be the same row.
+void step_wolfram_row(const uint8_t *source, uint8_t *out, int width, int rule, int edge_mode);
+
+// Same on packed rows of words_per_row(width) words each; padding bits of `source` must be zero
+// and are written as zero in `out`. `source` and `out` may not alias.
+void step_wolfram_bits(const uint64_t *source, uint64_t *out, int width, int rule, int edge_mode);
+
+// Tiles per atlas row; the atlas holds all 256 rules as a 16 x 16 grid of tiles.
+constexpr int WOLFRAM_ATLAS_COLUMNS = 16;
+
+// Runs every elementary rule from the same `seed` row (width 0/1 bytes) for `rows` rows, row 0 being
+// the seed, and writes them as tiles into `out`, a (16 * width) x (16 * rows) byte image with rule r
+// in tile (r % 16, r / 16). Each cell carries one bit per rule in four 64-bit lane words and the
+// rules are evaluated together, with rule bit k broadcast as a per-lane mask, so a row of all 256
+// rules costs about as many word operations as four single-rule rows cost in bytes.
+void build_wolfram_atlas(const uint8_t *seed, int width, int rows, int edge_mode, uint8_t *out);
+
+// Shared with another thread during step_wolfram_rows: `rows` counts the rows written so far, and
+// setting `cancel` stops the sweep before its next row.
+struct WolframProgress {
+    std::atomic<int64_t> rows{ 0 };
+    std::atomic<bool> cancel{ false };
+};
+
+// Sweeps `count` rows of a width x height byte grid in place, starting at `start_row`, each row
+// from the one above it (row 0 from the last row with wrap, from itself without). Without wrap the
+// sweep stops after the last row. The previous row stays packed between rows, so the working set
+// is two packed rows and every grid row is read once and written once. Returns the rows written.
+int64_t step_wolfram_rows(uint8_t *cells, int width, int height, int rule, int start_row, int64_t count, int edge_mode, bool allow_wrap,
+        WolframProgress *progress = nullptr);
+
+} // namespace automata
@@ -0,0 +1,146 @@
+#include "worker_pool.h"
+
+#include <algorithm>
+
+namespace automata {
+
+WorkerPool::~WorkerPool() {
+    stop_threads();
+}
+
+void WorkerPool::set_thread_count(int count) {
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex);
+    const int resolved = count > 0 ? count : static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+    if (started && resolved == thread_count) {
+        return;
+    }
+    stop_threads();
+    thread_count = resolved;
+    start_threads(thread_count - 1);
+}
+
+int WorkerPool::get_thread_count() const {
+    const int count = thread_count.load(std::memory_order_relaxed);
+    return count > 0 ? count : static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+}
+
+void WorkerPool::run(uint32_t count, const Job &job) {
+    if (count == 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> dispatch_lock(dispatch_mutex, std::try_to_lock);
+    if (!dispatch_lock.owns_lock() || count == 1) {
+        // Another caller owns the workers (or there is nothing to split): do the work here.
+        for (uint32_t i = 0; i < count; i++) {
+            job(i);
+        }
+        return;
+    }
+    if (!started) {
+        thread_count = get_thread_count();
+        start_threads(thread_count - 1);
+    }
+    if (threads.empty()) {
+        for (uint32_t i = 0; i < count; i++) {
+            job(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        current_job = &job;
+        job_count = count;
+        next_index.store(0, std::memory_order_relaxed);
+        busy_workers = static_cast<int>(threads.size());
+        generation++;
+    }
+    wake.notify_all();
+
+    drain();
+
+    std::unique_lock<std::mutex> lock(state_mutex);
+    done.wait(lock, [this]() { return busy_workers == 0; });
+    current_job = nullptr;
+}
+
+bool WorkerPool::run_row_bands(int rows, int min_band_rows, const std::function<bool(int, int)> &band) {
+    if (rows <= 0) {
+        return false;
+    }
+    // A few bands per thread keeps the tail short when some rows are cheaper than others.
+    const int max_bands = std::max(1, rows / std::max(1, min_band_rows));
+    const int bands = std::min(max_bands, get_thread_count() * 4);
+    if (bands == 1) {
+        return band(0, rows);
+    }
+
+    std::vector<uint8_t> changed(bands, 0);
+    run(static_cast<uint32_t>(bands), [&](uint32_t i) {
+        const int begin = static_cast<int>(static_cast<int64_t>(rows) * i / bands);
+        const int end = static_cast<int>(static_cast<int64_t>(rows) * (i + 1) / bands);
+        changed[i] = band(begin, end) ? 1 : 0;
+    });
+    return std::find(changed.begin(), changed.end(), 1) != changed.end();
+}
+
+void WorkerPool::drain() {
+    while (true) {
+        const uint32_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+        if (index >= job_count) {
+            break;
+        }
+        (*current_job)(index);
+    }
+}
+
+// `seen` is the generation current when the thread started, so a worker started after earlier
+// dispatches waits for the next one instead of joining (and counting itself out of) a stale one.
+void WorkerPool::worker_loop(uint64_t seen) {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(state_mutex);
+            wake.wait(lock, [&]() { return exiting || generation != seen; });
+            if (exiting) {
+                return;
+            }
+            seen = generation;
+        }
+
+        drain();
+
+        std::lock_guard<std::mutex> lock(state_mutex);
+        if (--busy_workers == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+void WorkerPool::start_threads(int workers) {
+    uint64_t current_generation;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        exiting = false;
+        current_generation = generation;
+    }
+    started = true;
+    for (int i = 0; i < workers; i++) {
+        threads.emplace_back(&WorkerPool::worker_loop, this, current_generation);
+    }
+}
+
+void WorkerPool::stop_threads() {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        exiting = true;
+    }
+    wake.notify_all();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    started = false;
+}
+
+} // namespace automata
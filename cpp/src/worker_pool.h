@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent worker threads for splitting one grid-wide kernel into independent jobs.
+//
+// Dispatch follows godot::ThreadWorkPool (workers pull job indices from a shared atomic counter)
+// but uses std primitives so it needs no engine objects, and the calling thread works too.
+// Only one job set runs at a time; a caller that finds the pool busy runs its jobs inline.
+
+namespace automata {
+
+class WorkerPool {
+public:
+    using Job = std::function<void(uint32_t)>;
+
+    WorkerPool() = default;
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+    ~WorkerPool();
+
+    // Total threads that execute jobs, including the caller. 0 picks the hardware thread count.
+    void set_thread_count(int count);
+    int get_thread_count() const;
+
+    // Runs job(i) for every i in [0, count) and returns once all of them finished.
+    void run(uint32_t count, const Job &job);
+
+    // Splits rows [0, rows) into contiguous bands of at least `min_band_rows` rows and runs
+    // band(begin, end) for each. Bands read neighbor (halo) rows from the unchanged source grid,
+    // so results do not depend on the thread count. Returns the OR of the band results.
+    bool run_row_bands(int rows, int min_band_rows, const std::function<bool(int, int)> &band);
+
+private:
+    void start_threads(int workers);
+    void stop_threads();
+    void worker_loop(uint64_t seen);
+    void drain();
+
+    std::mutex dispatch_mutex;
+
+    std::mutex state_mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::vector<std::thread> threads;
+    uint64_t generation = 0;
+    int busy_workers = 0;
+    bool exiting = false;
+
+    const Job *current_job = nullptr;
+    uint32_t job_count = 0;
+    std::atomic<uint32_t> next_index{ 0 };
+
+    // Read by get_thread_count() from any thread while run() or set_thread_count() may write it.
+    std::atomic<int> thread_count{ 0 };
+    bool started = false;
+};
+
+} // namespace automata
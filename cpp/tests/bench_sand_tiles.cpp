@@ -0,0 +1,70 @@
+#include "automata_common.h"
+#include "sand.h"
+#include "sand_tiles.h"
+#include "worker_pool.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Times relax_sand_tiles on single-spike falloff piles for 1..N threads, and the serial whole-grid
+// relax_sand_grid on the smaller pile (it takes minutes on the larger one). Every run is checked
+// against the first stable pile. Usage: bench_sand_tiles [max_threads], default the hardware count.
+
+using namespace automata;
+
+namespace {
+
+struct Pile {
+    int size;
+    int32_t grains;
+    bool serial;
+};
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int max_threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+    if (max_threads < 1) {
+        max_threads = 1;
+    }
+    WorkerPool pool;
+
+    const Pile piles[] = { { 512, 60000, true }, { 1024, 250000, false } };
+    for (const Pile &pile : piles) {
+        const size_t cells = static_cast<size_t>(pile.size) * pile.size;
+        const size_t center = static_cast<size_t>(pile.size / 2) * pile.size + pile.size / 2;
+        std::vector<int32_t> start(cells, 0);
+        start[center] = pile.grains;
+
+        printf("%dx%d, %d grains\n", pile.size, pile.size, pile.grains);
+        std::vector<int32_t> expected;
+        if (pile.serial) {
+            expected = start;
+            const auto begin = std::chrono::steady_clock::now();
+            const SandRelaxResult serial = relax_sand_grid(expected.data(), pile.size, pile.size, EDGE_FALLOFF, 0);
+            printf("  serial grid: %.1f ms, %lld topples\n", elapsed_ms(begin), static_cast<long long>(serial.topples));
+        }
+
+        for (int threads = 1; threads <= max_threads; threads++) {
+            pool.set_thread_count(threads);
+            std::vector<int32_t> grid = start;
+            const auto begin = std::chrono::steady_clock::now();
+            const SandRelaxResult tiled = relax_sand_tiles(grid.data(), pile.size, pile.size, EDGE_FALLOFF, 0, pool);
+            const double ms = elapsed_ms(begin);
+            if (expected.empty()) {
+                expected = grid;
+            }
+            printf("  tiles, %d thread%s: %.1f ms, %d passes%s\n", threads, threads == 1 ? "" : "s", ms, tiled.passes,
+                    grid == expected ? "" : " (MISMATCH)");
+        }
+    }
+    return 0;
+}
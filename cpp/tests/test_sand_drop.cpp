@@ -0,0 +1,95 @@
+#include "automata_common.h"
+#include "sand.h"
+#include "sand_tiles.h"
+#include "worker_pool.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// drop_sand_stabilized must leave exactly the pile that adding all grains to one cell and relaxing
+// serially leaves: wrap, bounce and falloff grids, von Neumann and Moore neighborhoods, classic
+// and larger thresholds. Drops that could keep a closed pile from settling must be refused with
+// the cells untouched.
+
+using namespace automata;
+
+namespace {
+
+int failures = 0;
+int compared = 0;
+int refused = 0;
+
+void report(const char *what, int width, int height, int edge_mode, const SandRule &rule, int64_t amount) {
+    if (++failures <= 20) {
+        printf("FAIL %s: %dx%d edge %d neighborhood %d threshold %d amount %lld\n", what, width, height, edge_mode, rule.neighborhood, rule.threshold,
+                static_cast<long long>(amount));
+    }
+}
+
+void check_drop(std::mt19937 &rng, WorkerPool &pool) {
+    const int width = 1 + static_cast<int>(rng() % 96);
+    const int height = 1 + static_cast<int>(rng() % 96);
+    const int edge_mode = static_cast<int>(rng() % 3);
+    SandRule rule;
+    rule.neighborhood = rng() & 1 ? SAND_MOORE : SAND_VON_NEUMANN;
+    rule.threshold = sand_neighbor_count(rule.neighborhood) + (rng() % 3 == 0 ? static_cast<int32_t>(rng() % 3) : 0);
+
+    // Start from a stable pile so the drop is the only source of topplings.
+    const size_t count = static_cast<size_t>(width) * height;
+    std::vector<int32_t> start(count);
+    const int32_t fill = sand_keeps_grains(edge_mode, rule) ? rule.threshold / 2 : rule.threshold;
+    int64_t grains = 0;
+    for (int32_t &cell : start) {
+        cell = static_cast<int32_t>(rng() % fill);
+        grains += cell;
+    }
+
+    // Closed piles take drops up to just under the guaranteed bound, and sometimes past it.
+    int64_t amount = 1 + static_cast<int64_t>(rng() % 20000);
+    if (sand_keeps_grains(edge_mode, rule)) {
+        const int64_t room = sand_neighbor_count(rule.neighborhood) / 2 * static_cast<int64_t>(count) - grains;
+        amount = rng() % 4 == 0 ? room + static_cast<int64_t>(rng() % 3) : 1 + static_cast<int64_t>(rng() % room);
+    }
+    const int x = static_cast<int>(rng() % width);
+    const int y = static_cast<int>(rng() % height);
+    const bool accepted = sand_settling_guaranteed(grains + amount, count, edge_mode, rule);
+
+    std::vector<int32_t> dropped = start;
+    const SandRelaxResult result = drop_sand_stabilized(dropped.data(), width, height, edge_mode, x, y, amount, pool, rule);
+    if (!accepted) {
+        refused++;
+        if (result.stable || result.topples != 0 || dropped != start) {
+            report("refused", width, height, edge_mode, rule, amount);
+        }
+        return;
+    }
+
+    std::vector<int32_t> expected = start;
+    expected[static_cast<size_t>(y) * width + x] += static_cast<int32_t>(amount);
+    const SandRelaxResult serial = relax_sand_grid(expected.data(), width, height, edge_mode, 0, rule);
+    compared++;
+    if (!serial.stable || !result.stable || dropped != expected) {
+        report("pile", width, height, edge_mode, rule, amount);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(2024);
+    WorkerPool pool;
+    pool.set_thread_count(4);
+
+    for (int i = 0; i < 300; i++) {
+        check_drop(rng, pool);
+    }
+
+    if (failures > 0) {
+        printf("test_sand_drop: %d mismatches\n", failures);
+        return 1;
+    }
+    printf("test_sand_drop ok (%d drops compared, %d refused)\n", compared, refused);
+    return 0;
+}
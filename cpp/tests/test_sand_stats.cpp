@@ -0,0 +1,151 @@
+#include "automata_common.h"
+#include "sand.h"
+#include "sand_pile.h"
+#include "sand_stats.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Avalanche recording must not change the pile: a recorded relax (whole or in budgeted slices)
+// reaches the pile and toppling count of an unrecorded one. Known avalanches land in the expected
+// histogram bins and per-cell totals, and reset_stats() clears them.
+
+using namespace automata;
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char *what) {
+    if (!condition && ++failures <= 20) {
+        printf("FAIL %s\n", what);
+    }
+}
+
+SandPile make_pile(int width, int height, int edge_mode, const SandRule &rule, const std::vector<int32_t> &cells, bool recording) {
+    SandPile pile;
+    pile.resize(width, height);
+    pile.set_edge_mode(edge_mode);
+    pile.set_rule(rule);
+    pile.set_recording(recording);
+    pile.load(cells.data());
+    return pile;
+}
+
+void check_recording_transparent(std::mt19937 &rng) {
+    const int width = 1 + static_cast<int>(rng() % 80);
+    const int height = 1 + static_cast<int>(rng() % 80);
+    const int edge_mode = static_cast<int>(rng() % 3);
+    SandRule rule;
+    if (rng() & 1) {
+        rule.neighborhood = SAND_MOORE;
+        rule.threshold = 8;
+    }
+    std::vector<int32_t> cells(static_cast<size_t>(width) * height);
+    const int32_t fill = sand_keeps_grains(edge_mode, rule) ? rule.threshold / 2 : rule.threshold;
+    for (int32_t &cell : cells) {
+        cell = static_cast<int32_t>(rng() % fill);
+    }
+    cells[static_cast<size_t>(height / 2) * width + width / 2] += edge_mode == EDGE_FALLOFF ? 2000 : rule.threshold;
+
+    SandPile plain = make_pile(width, height, edge_mode, rule, cells, false);
+    SandPile recorded = make_pile(width, height, edge_mode, rule, cells, true);
+    const SandRelaxResult expected = plain.relax(0);
+
+    // Budgeted slices carry the avalanche (and its worklist rounds) across calls.
+    SandRelaxResult slice;
+    int64_t topples = 0;
+    do {
+        slice = recorded.relax(1 + static_cast<int64_t>(rng() % 500));
+        topples += slice.topples;
+    } while (!slice.stable);
+
+    std::vector<int32_t> plain_cells(cells.size());
+    std::vector<int32_t> recorded_cells(cells.size());
+    plain.store(plain_cells.data());
+    recorded.store(recorded_cells.data());
+    check(expected.stable, "unrecorded relax settles");
+    check(plain_cells == recorded_cells, "recorded pile matches unrecorded pile");
+    check(topples == expected.topples, "recorded topples match unrecorded topples");
+
+    const SandAvalancheStats &stats = recorded.get_stats();
+    if (expected.topples > 0) {
+        check(stats.get_avalanche_count() == 1, "one avalanche recorded");
+        check(stats.get_last().topples == expected.topples, "avalanche size is the topple count");
+        int64_t cell_total = 0;
+        int64_t area = 0;
+        for (int64_t count : stats.get_cell_topples()) {
+            cell_total += count;
+            area += count > 0;
+        }
+        check(cell_total == expected.topples, "per-cell topples sum to the avalanche size");
+        check(stats.get_last().area == area, "area counts the cells that toppled");
+    }
+}
+
+int64_t histogram_total(const SandAvalancheStats::Histogram &histogram) {
+    int64_t total = 0;
+    for (int64_t count : histogram) {
+        total += count;
+    }
+    return total;
+}
+
+void check_known_avalanches() {
+    // A lone 4 in the middle of an empty 5x5 falloff pile topples once: size 1, area 1, one round.
+    std::vector<int32_t> cells(25, 0);
+    cells[12] = 4;
+    SandPile pile = make_pile(5, 5, EDGE_FALLOFF, SandRule(), cells, true);
+    const SandRelaxResult single = pile.relax(0);
+    const SandAvalancheStats &stats = pile.get_stats();
+    check(single.stable && single.topples == 1, "single topple relaxes");
+    check(stats.get_avalanche_count() == 1, "single avalanche counted");
+    check(stats.get_last().topples == 1 && stats.get_last().area == 1 && stats.get_last().duration == 1, "single avalanche size, area and duration");
+    check(stats.get_size_histogram()[1] == 1 && histogram_total(stats.get_size_histogram()) == 1, "single avalanche size bin");
+    check(stats.get_area_histogram()[1] == 1 && histogram_total(stats.get_area_histogram()) == 1, "single avalanche area bin");
+    check(stats.get_duration_histogram()[1] == 1 && histogram_total(stats.get_duration_histogram()) == 1, "single avalanche duration bin");
+    for (size_t i = 0; i < cells.size(); i++) {
+        check(stats.get_cell_topples()[i] == (i == 12 ? 1 : 0), "single avalanche per-cell topples");
+    }
+
+    // 12 grains on the same cell of an emptied pile topple three times in one visit: size bin
+    // [2, 4), area still 1. Loading new cells keeps the statistics.
+    cells[12] = 12;
+    pile.load(cells.data());
+    pile.relax(0);
+    check(stats.get_avalanche_count() == 2, "second avalanche counted");
+    check(stats.get_last().topples == 3 && stats.get_last().area == 1 && stats.get_last().duration == 1, "batched avalanche size, area and duration");
+    check(stats.get_size_histogram()[2] == 1 && stats.get_area_histogram()[1] == 2, "batched avalanche bins");
+    check(stats.get_largest().topples == 3, "largest avalanche kept");
+    check(stats.get_cell_topples()[12] == 4, "per-cell topples accumulate");
+
+    pile.reset_stats();
+    check(stats.get_avalanche_count() == 0 && stats.get_largest().topples == 0 && stats.get_last().topples == 0, "reset clears the counters");
+    check(histogram_total(stats.get_size_histogram()) == 0 && histogram_total(stats.get_area_histogram()) == 0
+                    && histogram_total(stats.get_duration_histogram()) == 0,
+            "reset clears the histograms");
+    bool cells_clear = true;
+    for (int64_t count : stats.get_cell_topples()) {
+        cells_clear &= count == 0;
+    }
+    check(cells_clear, "reset clears the per-cell topples");
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(77);
+    for (int i = 0; i < 150; i++) {
+        check_recording_transparent(rng);
+    }
+    check_known_avalanches();
+
+    if (failures > 0) {
+        printf("test_sand_stats: %d failures\n", failures);
+        return 1;
+    }
+    printf("test_sand_stats ok\n");
+    return 0;
+}
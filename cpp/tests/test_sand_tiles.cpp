@@ -0,0 +1,101 @@
+#include "automata_common.h"
+#include "sand.h"
+#include "sand_tiles.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+// relax_sand_tiles must reach exactly the pile and toppling count of the serial relax_sand_grid:
+// random piles on wrap, bounce and falloff grids, von Neumann and Moore neighborhoods, every
+// thread count from 1 to the hardware count (at least 4), with and without seeds.
+
+using namespace automata;
+
+namespace {
+
+int failures = 0;
+int compared = 0;
+
+void report(const char *what, int width, int height, int edge_mode, const SandRule &rule, int threads) {
+    if (++failures <= 20) {
+        printf("FAIL %s: %dx%d edge %d neighborhood %d threshold %d threads %d\n", what, width, height, edge_mode, rule.neighborhood, rule.threshold,
+                threads);
+    }
+}
+
+void check_pile(std::mt19937 &rng, WorkerPool &pool, int max_threads) {
+    const int width = 1 + static_cast<int>(rng() % 200);
+    const int height = 1 + static_cast<int>(rng() % 200);
+    const int edge_mode = static_cast<int>(rng() % 3);
+    SandRule rule;
+    if (rng() & 1) {
+        rule.neighborhood = SAND_MOORE;
+        rule.threshold = 8;
+    }
+
+    // Grids that keep their grains only stabilize below threshold / 2 per cell on average, so
+    // those start sparse; falloff grids drain and take a tall spike.
+    std::vector<int32_t> start(static_cast<size_t>(width) * height);
+    const int32_t fill = edge_mode == EDGE_FALLOFF ? rule.threshold : rule.threshold / 2 + 1;
+    for (int32_t &cell : start) {
+        cell = static_cast<int32_t>(rng() % fill);
+    }
+    const size_t center = static_cast<size_t>(height / 2) * width + width / 2;
+    start[center] += edge_mode == EDGE_FALLOFF ? 3000 : rule.threshold;
+    const int64_t budget = edge_mode == EDGE_FALLOFF ? 0 : 2000000;
+
+    std::vector<int32_t> expected = start;
+    const SandRelaxResult serial = relax_sand_grid(expected.data(), width, height, edge_mode, budget, rule);
+
+    for (int threads = 1; threads <= max_threads; threads++) {
+        pool.set_thread_count(threads);
+        std::vector<int32_t> actual = start;
+        const SandRelaxResult tiled = relax_sand_tiles(actual.data(), width, height, edge_mode, budget, pool, rule);
+        if (serial.stable != tiled.stable) {
+            report("stable", width, height, edge_mode, rule, threads);
+        } else if (serial.stable) {
+            compared++;
+            if (actual != expected || tiled.topples != serial.topples) {
+                report("pile", width, height, edge_mode, rule, threads);
+            }
+        }
+    }
+
+    // A seeded relax only scans the seed's tile; the pile must still match the serial one.
+    if (edge_mode == EDGE_FALLOFF) {
+        std::vector<int32_t> seeded(start.size(), 0);
+        const int32_t seed = static_cast<int32_t>(static_cast<size_t>(height / 3) * width + width / 4);
+        seeded[seed] = 2000;
+        std::vector<int32_t> serial_seeded = seeded;
+        relax_sand_grid(serial_seeded.data(), width, height, edge_mode, 0, rule);
+        pool.set_thread_count(max_threads);
+        const SandRelaxResult tiled = relax_sand_tiles(seeded.data(), width, height, edge_mode, 0, pool, rule, &seed, 1);
+        if (!tiled.stable || seeded != serial_seeded) {
+            report("seeded", width, height, edge_mode, rule, max_threads);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(4242);
+    const int max_threads = std::max(4, static_cast<int>(std::thread::hardware_concurrency()));
+    WorkerPool pool;
+
+    for (int i = 0; i < 120; i++) {
+        check_pile(rng, pool, max_threads);
+    }
+
+    if (failures > 0) {
+        printf("test_sand_tiles: %d mismatches\n", failures);
+        return 1;
+    }
+    printf("test_sand_tiles ok (%d stable piles, 1..%d threads)\n", compared, max_threads);
+    return 0;
+}
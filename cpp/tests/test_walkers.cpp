@@ -0,0 +1,185 @@
+#include "automata_common.h"
+#include "walkers.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// WalkerStore::step must move ants and turmites exactly like the per-walker loop of
+// NativeAutomata.step_ants / step_turmites, reproduced below on plain vectors: wrap, bounce and
+// falloff grids, walkers starting off the grid, several walkers on one cell (the earlier one
+// flips it first), bounce reversal and falloff removal. remove_in_rect keeps the survivors' order.
+
+using namespace automata;
+
+namespace {
+
+constexpr int DIR_X[4] = { 0, 1, 0, -1 };
+constexpr int DIR_Y[4] = { -1, 0, 1, 0 };
+
+struct Walker {
+    int32_t x;
+    int32_t y;
+    int dir;
+    uint8_t color;
+
+    bool operator==(const Walker &other) const {
+        return x == other.x && y == other.y && dir == other.dir && color == other.color;
+    }
+};
+
+int failures = 0;
+
+void check(bool condition, const char *what) {
+    if (!condition && ++failures <= 20) {
+        printf("FAIL %s\n", what);
+    }
+}
+
+// The baseline loop: turn on the cell state, flip it, step forward under the edge mode.
+void reference_step(std::vector<uint8_t> &cells, int width, int height, int edge_mode, const bool turns[2], std::vector<Walker> &walkers) {
+    std::vector<Walker> next_walkers;
+    for (const Walker &walker : walkers) {
+        if (walker.x < 0 || walker.x >= width || walker.y < 0 || walker.y >= height) {
+            continue;
+        }
+        uint8_t &cell = cells[static_cast<size_t>(walker.y) * width + walker.x];
+        const uint8_t current = cell;
+        int dir = turns[current] ? (walker.dir + 1) % 4 : (walker.dir + 3) % 4;
+        cell = static_cast<uint8_t>(1 - current);
+
+        int nx = walker.x + DIR_X[dir];
+        int ny = walker.y + DIR_Y[dir];
+        const bool outside = nx < 0 || nx >= width || ny < 0 || ny >= height;
+        if (edge_mode == EDGE_WRAP) {
+            nx = wrap_axis(nx, width);
+            ny = wrap_axis(ny, height);
+        } else if (edge_mode == EDGE_BOUNCE) {
+            if (outside) {
+                dir = (dir + 2) % 4;
+                nx = clamp_axis(walker.x + DIR_X[dir], width);
+                ny = clamp_axis(walker.y + DIR_Y[dir], height);
+            }
+        } else if (outside) {
+            continue;
+        }
+        next_walkers.push_back({ nx, ny, dir, walker.color });
+    }
+    walkers = next_walkers;
+}
+
+std::vector<Walker> store_walkers(const WalkerStore &store) {
+    std::vector<Walker> walkers;
+    for (size_t i = 0; i < store.size(); i++) {
+        walkers.push_back({ store.get_x()[i], store.get_y()[i], store.get_dirs()[i], store.get_palette()[i] });
+    }
+    return walkers;
+}
+
+void check_random(std::mt19937 &rng) {
+    const int width = 1 + static_cast<int>(rng() % 40);
+    const int height = 1 + static_cast<int>(rng() % 40);
+    const int edge_mode = static_cast<int>(rng() % 3);
+    const bool turns[2] = { (rng() & 1) != 0, (rng() & 1) != 0 };
+
+    std::vector<uint8_t> cells(static_cast<size_t>(width) * height);
+    for (uint8_t &cell : cells) {
+        cell = static_cast<uint8_t>(rng() & 1);
+    }
+    // A few walkers start just off the grid; small grids make walkers share cells often.
+    std::vector<Walker> walkers;
+    const int count = 1 + static_cast<int>(rng() % 60);
+    for (int i = 0; i < count; i++) {
+        walkers.push_back({ static_cast<int32_t>(rng() % (width + 2)) - 1, static_cast<int32_t>(rng() % (height + 2)) - 1, static_cast<int>(rng() % 4),
+                static_cast<uint8_t>(i) });
+    }
+
+    WalkerStore store;
+    for (const Walker &walker : walkers) {
+        store.add(walker.x, walker.y, walker.dir, walker.color);
+    }
+    std::vector<uint8_t> store_cells = cells;
+    for (int step = 0; step < 50; step++) {
+        const size_t before = walkers.size();
+        reference_step(cells, width, height, edge_mode, turns, walkers);
+        const WalkerStep moved = store.step(store_cells.data(), width, height, edge_mode, turns);
+        check(moved.removed == before - walkers.size(), "removed count matches");
+        // Every walker either flips its cell or leaves, so any walker means a change.
+        check(moved.changed == (before > 0), "changed whenever a walker was on the store");
+    }
+    check(store_cells == cells, "grid matches the baseline loop");
+    check(store_walkers(store) == walkers, "walkers match the baseline loop");
+}
+
+void check_cases() {
+    const bool ant[2] = { false, true };
+
+    // Falloff: an ant on a white corner cell facing up turns left off the grid and is removed.
+    {
+        std::vector<uint8_t> cells(9, 0);
+        WalkerStore store;
+        store.add(0, 0, 0, 0);
+        store.add(1, 1, 0, 1);
+        const WalkerStep moved = store.step(cells.data(), 3, 3, EDGE_FALLOFF, ant);
+        check(moved.removed == 1 && store.size() == 1, "falloff removes the walker leaving the grid");
+        check(store.get_x()[0] == 0 && store.get_y()[0] == 1 && store.get_palette()[0] == 1, "falloff keeps the other walker");
+        check(cells[0] == 1 && cells[4] == 1, "both walkers flipped their cell");
+    }
+
+    // Bounce: the same ant reverses onto the grid instead, facing right.
+    {
+        std::vector<uint8_t> cells(9, 0);
+        WalkerStore store;
+        store.add(0, 0, 0, 0);
+        store.step(cells.data(), 3, 3, EDGE_BOUNCE, ant);
+        check(store.size() == 1 && store.get_x()[0] == 1 && store.get_y()[0] == 0 && store.get_dirs()[0] == 1, "bounce reverses the walker");
+    }
+
+    // Two ants on one white cell: the first flips it black and turns left, the second then sees
+    // black and turns right, flipping it back.
+    {
+        std::vector<uint8_t> cells(25, 0);
+        WalkerStore store;
+        store.add(2, 2, 0, 0);
+        store.add(2, 2, 0, 1);
+        store.step(cells.data(), 5, 5, EDGE_WRAP, ant);
+        check(cells[12] == 0, "shared cell flipped twice");
+        check(store.get_x()[0] == 1 && store.get_dirs()[0] == 3, "first walker turned left");
+        check(store.get_x()[1] == 3 && store.get_dirs()[1] == 1, "second walker turned right");
+    }
+
+    // remove_in_rect drops walkers inside [x0, x1) x [y0, y1) and keeps the rest in order.
+    {
+        WalkerStore store;
+        for (int i = 0; i < 8; i++) {
+            store.add(i, i, i, static_cast<uint8_t>(i));
+        }
+        check(store.remove_in_rect(2, 2, 5, 5) == 3, "remove_in_rect count");
+        const uint8_t kept[] = { 0, 1, 5, 6, 7 };
+        bool ordered = store.size() == 5;
+        for (size_t i = 0; ordered && i < store.size(); i++) {
+            ordered = store.get_palette()[i] == kept[i] && store.get_x()[i] == kept[i] && store.get_dirs()[i] == (kept[i] & 3);
+        }
+        check(ordered, "remove_in_rect keeps survivors in order");
+        check(store.any_at(6, 6) && !store.any_at(3, 3), "any_at after removal");
+        check(store.remove_in_rect(0, 0, 0, 10) == 0, "empty rect removes nothing");
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(31337);
+    for (int i = 0; i < 300; i++) {
+        check_random(rng);
+    }
+    check_cases();
+
+    if (failures > 0) {
+        printf("test_walkers: %d failures\n", failures);
+        return 1;
+    }
+    printf("test_walkers ok\n");
+    return 0;
+}
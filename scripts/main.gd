@@ -3,6 +3,7 @@ class_name CellularAutomataHub
 extends Control
 
 const DIRS: Array[Vector2i] = [Vector2i.UP, Vector2i.RIGHT, Vector2i.DOWN, Vector2i.LEFT]
+const MOORE_DIRS: Array[Vector2i] = [Vector2i.UP, Vector2i.RIGHT, Vector2i.DOWN, Vector2i.LEFT, Vector2i(-1, -1), Vector2i(1, -1), Vector2i(1, 1), Vector2i(-1, 1)]
 const EDGE_WRAP: int = 0
 const EDGE_BOUNCE: int = 1
 const EDGE_FALLOFF: int = 2
@@ -31,6 +32,7 @@ var wolfram_row: int = 0
 var wolfram_rate: float = 1.0
 var wolfram_accumulator: float = 0.0
 var wolfram_enabled: bool = false
+var wolfram_scroll: bool = false
 
 var ant_rate: float = 1.0
 var ant_accumulator: float = 0.0
@@ -54,7 +56,15 @@ var sand_enabled: bool = false
 var sand_grid: PackedInt32Array = PackedInt32Array()
 var sand_drop_amount: int = 1000
 var sand_drop_at_click: bool = false
-
+# Sand neighborhoods, matching the native `neighborhood` argument.
+const SAND_VON_NEUMANN: int = 0
+const SAND_MOORE: int = 1
+# Grains a cell needs before it topples, and which neighbors receive them.
+var sand_threshold: int = 4
+var sand_neighborhood: int = SAND_VON_NEUMANN
+
+# Single-cell topplings the native relax_sand may do per sand step; keeps one call within a frame.
+const SAND_RELAX_BUDGET: int = 2000000
 const SAND_PALETTE_PRESETS: Dictionary = {
 	"Desert": [Color(0.93, 0.82, 0.57), Color(0.86, 0.67, 0.45), Color(0.71, 0.52, 0.33), Color(0.49, 0.36, 0.25)],
 	"Pastel": [Color(0.91, 0.91, 0.98), Color(0.74, 0.86, 0.96), Color(0.56, 0.77, 0.93), Color(0.38, 0.69, 0.89)],
@@ -138,8 +148,17 @@ var render_task_mutex: Mutex = Mutex.new()
 
 var sim_workers: Dictionary = {}
 const SIM_KEYS: Array[String] = ["totalistic", "wolfram", "ants", "turmites", "sand"]
+# Wall-clock time each automaton may spend stepping per frame; steps owed beyond it are dropped
+# rather than carried into the next frame.
+const SIM_STEP_BUDGET_USEC: int = 8000
 
 var native_automata: RefCounted = null
+var native_sandpile: RefCounted = null
+var native_wolfram: RefCounted = null
+# Ants and turmites live in these NativeWalkers stores when the extension provides them; the
+# ants/turmites arrays below then stay empty.
+var native_ants: RefCounted = null
+var native_turmites: RefCounted = null
 
 var step_requested: bool = false
 
@@ -182,6 +201,8 @@ var sand_has_content: bool = false
 @onready var turmite_rule_edit: LineEdit = LineEdit.new()
 @onready var sand_rate_spin: SpinBox = SpinBox.new()
 @onready var sand_amount_spin: SpinBox = SpinBox.new()
+@onready var sand_threshold_spin: SpinBox = SpinBox.new()
+@onready var sand_neighborhood_option: OptionButton = OptionButton.new()
 @onready var sand_palette_option: OptionButton = OptionButton.new()
 var sand_color_pickers: Array[ColorPickerButton] = []
 @onready var draw_mode_option: OptionButton = OptionButton.new()
@@ -429,6 +450,13 @@ func initialize_native_automata() -> void:
 		if instance is RefCounted:
 			native_automata = instance as RefCounted
 			print("[NativeAutomata] Loaded native extension")
+			if ClassDB.class_exists("NativeSandpile"):
+				native_sandpile = ClassDB.instantiate("NativeSandpile") as RefCounted
+			if ClassDB.class_exists("NativeWolfram"):
+				native_wolfram = ClassDB.instantiate("NativeWolfram") as RefCounted
+			if ClassDB.class_exists("NativeWalkers"):
+				native_ants = ClassDB.instantiate("NativeWalkers") as RefCounted
+				native_turmites = ClassDB.instantiate("NativeWalkers") as RefCounted
 		else:
 			print("[NativeAutomata] Failed to instantiate native extension, using GDScript")
 	else:
@@ -963,7 +991,13 @@ func build_wolfram_controls() -> VBoxContainer:
 	step.text = "Step"
 	step.pressed.connect(func() -> void: step_wolfram(); request_render())
 	buttons.add_child(step)
+	var scroll_toggle: CheckBox = CheckBox.new()
+	scroll_toggle.text = "Scroll"
+	scroll_toggle.button_pressed = wolfram_scroll
+	scroll_toggle.toggled.connect(func(v: bool) -> void: set_wolfram_scroll(v))
+	buttons.add_child(scroll_toggle)
 	register_help(toggle, "Continuously generate new Wolfram rows at the selected rate.")
+	register_help(scroll_toggle, "Keep the newest row at the bottom and scroll older rows up instead of wrapping back to the top.")
 	register_help(step, "Generate a single Wolfram row using the active rule and seed.")
 	box.add_child(buttons)
 
@@ -1255,6 +1289,35 @@ func build_sand_controls() -> VBoxContainer:
 	register_help(drop_button, "Drop the configured sand amount into the center of the grid.")
 	box.add_child(amount_row)
 
+	var rule_row: HBoxContainer = HBoxContainer.new()
+	var neighborhood_label: Label = Label.new()
+	neighborhood_label.text = "Neighbors"
+	rule_row.add_child(neighborhood_label)
+	sand_neighborhood_option.clear()
+	sand_neighborhood_option.add_item("4 (von Neumann)", SAND_VON_NEUMANN)
+	sand_neighborhood_option.add_item("8 (Moore)", SAND_MOORE)
+	sand_neighborhood_option.select(sand_neighborhood_option.get_item_index(sand_neighborhood))
+	sand_neighborhood_option.item_selected.connect(func(index: int) -> void:
+		sand_neighborhood = sand_neighborhood_option.get_item_id(index)
+		# A toppling cell must lose at least one grain per neighbor, so keep the threshold in range.
+		var neighbors: int = 8 if sand_neighborhood == SAND_MOORE else 4
+		sand_threshold_spin.min_value = neighbors
+		sand_threshold_spin.value = neighbors
+	)
+	rule_row.add_child(sand_neighborhood_option)
+	var threshold_label: Label = Label.new()
+	threshold_label.text = "Threshold"
+	rule_row.add_child(threshold_label)
+	sand_threshold_spin.min_value = 8 if sand_neighborhood == SAND_MOORE else 4
+	sand_threshold_spin.max_value = 128
+	enforce_integer_spin(sand_threshold_spin, 0)
+	sand_threshold_spin.value = sand_threshold
+	sand_threshold_spin.value_changed.connect(func(v: float) -> void: sand_threshold = int(v))
+	rule_row.add_child(sand_threshold_spin)
+	register_help(sand_neighborhood_option, "Which neighbors receive grains: the 4 orthogonal cells or all 8 surrounding cells. Switching resets the threshold to the neighbor count.")
+	register_help(sand_threshold_spin, "Grains a cell needs before it topples. It never drops below the neighbor count; grains above it are lost on each topple.")
+	box.add_child(rule_row)
+
 	var click_row: HBoxContainer = HBoxContainer.new()
 	sand_click_toggle.text = "Drop at click"
 	sand_click_toggle.button_pressed = sand_drop_at_click
@@ -1434,6 +1497,8 @@ func update_grid_size() -> void:
 	)
 	var size_changed: bool = new_size != grid_size or grid.size() != new_size.x * new_size.y
 	if size_changed:
+		# Rows are copied by screen position, so a scrolled sweep is unrolled at the old size first.
+		settle_wolfram_scroll()
 		var old_size: Vector2i = grid_size
 		var old_grid: PackedByteArray = grid.duplicate()
 		var old_sand: PackedInt32Array = sand_grid.duplicate()
@@ -1460,6 +1525,10 @@ func update_grid_size() -> void:
 		sand_grid = new_sand
 
 		wolfram_row = min(wolfram_row, grid_size.y)
+		if native_ants != null:
+			native_ants.call("wrap_positions", grid_size)
+		if native_turmites != null:
+			native_turmites.call("wrap_positions", grid_size)
 		for i in range(ants.size()):
 			ants[i] = wrap_position(ants[i])
 		for i in range(turmites.size()):
@@ -1481,6 +1550,39 @@ func random_fill_grid() -> void:
 	wolfram_row = 0
 	request_render()
 
+func set_wolfram_scroll(enabled: bool) -> void:
+	if not enabled:
+		settle_wolfram_scroll()
+	wolfram_scroll = enabled
+	request_render()
+
+# While scrolling, the Wolfram sweep wraps and `grid` is a ring of rows whose oldest row, shown at
+# the top, is the next one to be written; the shader applies this offset when drawing.
+func wolfram_row_offset() -> int:
+	if not wolfram_scroll or grid_size.y <= 0:
+		return 0
+	return posmod(wolfram_row, grid_size.y)
+
+# Rotates a scrolled grid back into display order, so code that indexes `grid` by screen row
+# (drawing, the other automata) sees what is on screen. One pass over the grid, and only when the
+# view is actually scrolled.
+func settle_wolfram_scroll() -> void:
+	var offset: int = wolfram_row_offset()
+	if offset == 0:
+		return
+	if native_wolfram != null:
+		native_wolfram.call("sync_grid", grid, grid_size)
+		native_wolfram.call("set_head", offset)
+		native_wolfram.call("unroll")
+		grid = native_wolfram.call("get_grid")
+	else:
+		var split: int = offset * grid_size.x
+		var rotated: PackedByteArray = grid.slice(split)
+		rotated.append_array(grid.slice(0, split))
+		grid = rotated
+	wolfram_row = 0
+	request_render()
+
 func seed_wolfram_row(randomize: bool) -> void:
 	var rng: RandomNumberGenerator = RandomNumberGenerator.new()
 	rng.randomize()
@@ -1498,6 +1600,10 @@ func seed_wolfram_row(randomize: bool) -> void:
 func spawn_ants(count: int, color: Color) -> void:
 	var rng: RandomNumberGenerator = RandomNumberGenerator.new()
 	rng.randomize()
+	if native_ants != null:
+		native_ants.call("spawn_random", count, grid_size, color, rng.randi())
+		request_render()
+		return
 	for i in range(count):
 		ants.append(Vector2i(rng.randi_range(0, grid_size.x - 1), rng.randi_range(0, grid_size.y - 1)))
 		ant_directions.append(rng.randi_range(0, DIRS.size() - 1))
@@ -1505,6 +1611,8 @@ func spawn_ants(count: int, color: Color) -> void:
 	request_render()
 
 func clear_ants() -> void:
+	if native_ants != null:
+		native_ants.call("clear")
 	ants.clear()
 	ant_directions.clear()
 	ant_colors.clear()
@@ -1588,6 +1696,9 @@ func add_ant_at(pos: Vector2i, direction: int, color: Color) -> bool:
 	if pos.x < 0 or pos.x >= grid_size.x or pos.y < 0 or pos.y >= grid_size.y:
 		return false
 	var changed: bool = remove_ants_at(pos)
+	if native_ants != null:
+		native_ants.call("add_walker", pos, direction % DIRS.size(), color)
+		return true
 	ants.append(pos)
 	ant_directions.append(direction % DIRS.size())
 	ant_colors.append(color)
@@ -1597,6 +1708,9 @@ func add_turmite_at(pos: Vector2i, direction: int, color: Color) -> bool:
 	if pos.x < 0 or pos.x >= grid_size.x or pos.y < 0 or pos.y >= grid_size.y:
 		return false
 	var changed: bool = remove_turmites_at(pos)
+	if native_turmites != null:
+		native_turmites.call("add_walker", pos, direction % DIRS.size(), color)
+		return true
 	turmites.append(pos)
 	turmite_directions.append(direction % DIRS.size())
 	turmite_colors.append(color)
@@ -1634,6 +1748,7 @@ func any_draw_enabled() -> bool:
 	return draw_enabled or ant_draw_enabled or turmite_draw_enabled
 
 func apply_draw_targets(pos: Vector2i) -> bool:
+	settle_wolfram_scroll()
 	var changed: bool = false
 	if ant_draw_enabled:
 		changed = apply_ant_draw_action(pos) or changed
@@ -1672,23 +1787,40 @@ func process_wolfram(delta: float) -> bool:
 		return false
 	wolfram_accumulator += delta
 	var interval: float = 1.0 / wolfram_rate
+	if native_wolfram != null:
+		var steps: int = 0
+		while wolfram_accumulator >= interval:
+			wolfram_accumulator -= interval
+			steps += 1
+		if steps == 0:
+			return false
+		step_wolfram_native(steps, true, SIM_STEP_BUDGET_USEC)
+		return true
 	var stepped: bool = false
+	var started_usec: int = Time.get_ticks_usec()
 	while wolfram_accumulator >= interval:
 		step_wolfram()
 		wolfram_accumulator -= interval
 		stepped = true
+		if Time.get_ticks_usec() - started_usec >= SIM_STEP_BUDGET_USEC:
+			wolfram_accumulator = fmod(wolfram_accumulator, interval)
+			break
 	return stepped
 
 func process_ants(delta: float) -> bool:
-	if not ants_enabled or ant_rate <= 0.0 or ants.is_empty():
+	if not ants_enabled or ant_rate <= 0.0 or ant_count() == 0:
 		return false
 	ant_accumulator += delta
 	var interval: float = 1.0 / ant_rate
 	var stepped: bool = false
+	var started_usec: int = Time.get_ticks_usec()
 	while ant_accumulator >= interval:
 		step_ants()
 		ant_accumulator -= interval
 		stepped = true
+		if Time.get_ticks_usec() - started_usec >= SIM_STEP_BUDGET_USEC:
+			ant_accumulator = fmod(ant_accumulator, interval)
+			break
 	return stepped
 
 func process_game_of_life(delta: float) -> bool:
@@ -1696,47 +1828,57 @@ func process_game_of_life(delta: float) -> bool:
 		return false
 	gol_accumulator += delta
 	var interval: float = 1.0 / gol_rate
-	var stepped: bool = false
+	var steps: int = 0
 	while gol_accumulator >= interval:
-		step_game_of_life()
 		gol_accumulator -= interval
-		stepped = true
-	return stepped
+		steps += 1
+	if steps == 0:
+		return false
+	step_totalistic_generations([3], [2, 3], steps)
+	return true
 
 func process_day_night(delta: float) -> bool:
 	if not day_night_enabled or day_night_rate <= 0.0:
 		return false
 	day_night_accumulator += delta
 	var interval: float = 1.0 / day_night_rate
-	var stepped: bool = false
+	var steps: int = 0
 	while day_night_accumulator >= interval:
-		step_day_night()
 		day_night_accumulator -= interval
-		stepped = true
-	return stepped
+		steps += 1
+	if steps == 0:
+		return false
+	step_totalistic_generations([3, 6, 7, 8], [3, 4, 6, 7, 8], steps)
+	return true
 
 func process_seeds(delta: float) -> bool:
 	if not seeds_enabled or seeds_rate <= 0.0:
 		return false
 	seeds_accumulator += delta
 	var interval: float = 1.0 / seeds_rate
-	var stepped: bool = false
+	var steps: int = 0
 	while seeds_accumulator >= interval:
-		step_seeds()
 		seeds_accumulator -= interval
-		stepped = true
-	return stepped
+		steps += 1
+	if steps == 0:
+		return false
+	step_totalistic_generations([2], [], steps)
+	return true
 
 func process_turmites(delta: float) -> bool:
-	if not turmite_enabled or turmite_rate <= 0.0 or turmites.is_empty():
+	if not turmite_enabled or turmite_rate <= 0.0 or turmite_count() == 0:
 		return false
 	turmite_accumulator += delta
 	var interval: float = 1.0 / turmite_rate
 	var stepped: bool = false
+	var started_usec: int = Time.get_ticks_usec()
 	while turmite_accumulator >= interval:
 		step_turmites(false)
 		turmite_accumulator -= interval
 		stepped = true
+		if Time.get_ticks_usec() - started_usec >= SIM_STEP_BUDGET_USEC:
+			turmite_accumulator = fmod(turmite_accumulator, interval)
+			break
 	return stepped
 
 func process_sand(delta: float) -> bool:
@@ -1745,16 +1887,22 @@ func process_sand(delta: float) -> bool:
 	sand_accumulator += delta
 	var interval: float = 1.0 / sand_rate
 	var stepped: bool = false
+	var started_usec: int = Time.get_ticks_usec()
 	while sand_accumulator >= interval:
 		step_sand()
 		sand_accumulator -= interval
 		stepped = true
+		if Time.get_ticks_usec() - started_usec >= SIM_STEP_BUDGET_USEC:
+			sand_accumulator = fmod(sand_accumulator, interval)
+			break
 	return stepped
 
 func step_wolfram(allow_wrap: bool = true) -> void:
-	step_wolfram_with_workers(allow_wrap, true)
+	step_wolfram_with_workers(allow_wrap or wolfram_scroll, true)
 
 func step_wolfram_with_workers(allow_wrap: bool, use_workers: bool) -> void:
+	if step_wolfram_native(1, allow_wrap, 0):
+		return
 	if native_automata != null and native_automata.has_method("step_wolfram"):
 		var native_result: Dictionary = native_automata.call("step_wolfram", grid, grid_size, wolfram_rule, wolfram_row, edge_mode, allow_wrap)
 		if native_result.has("grid") and native_result["grid"] is PackedByteArray:
@@ -1790,19 +1938,83 @@ func step_wolfram_with_workers(allow_wrap: bool, use_workers: bool) -> void:
 	wolfram_row = (wolfram_row + 1) % grid_size.y if allow_wrap else wolfram_row + 1
 	request_render()
 
+# Writes up to `count` rows into the grid NativeWolfram owns and fetches it once at the end, so
+# each row costs one row rather than a copy of the grid. Stops early past the last row (without
+# wrap) or once `budget_usec` is spent; without a budget all rows run in one native call.
+# Returns false without NativeWolfram.
+func step_wolfram_native(count: int, allow_wrap: bool, budget_usec: int) -> bool:
+	if native_wolfram == null:
+		return false
+	native_wolfram.call("sync_grid", grid, grid_size)
+	var wrote: bool = false
+	if budget_usec <= 0:
+		wrote = _wolfram_native_rows(count, allow_wrap)
+	else:
+		var started_usec: int = Time.get_ticks_usec()
+		for _i in range(count):
+			if not _wolfram_native_rows(1, allow_wrap):
+				break
+			wrote = true
+			if Time.get_ticks_usec() - started_usec >= budget_usec:
+				break
+	if wrote:
+		grid = native_wolfram.call("get_grid")
+		request_render()
+	return true
+
+# Writes `count` rows at wolfram_row; scrolling goes through the ring API, whose head is the same
+# row. Returns true when any row was written.
+func _wolfram_native_rows(count: int, allow_wrap: bool) -> bool:
+	var rows_result: Dictionary = {}
+	if wolfram_scroll:
+		native_wolfram.call("set_head", wolfram_row)
+		rows_result = native_wolfram.call("scroll_rows", wolfram_rule, count, edge_mode)
+		wolfram_row = int(rows_result.get("head", wolfram_row))
+	else:
+		rows_result = native_wolfram.call("step_rows", wolfram_rule, wolfram_row, count, edge_mode, allow_wrap)
+		wolfram_row = int(rows_result.get("row", wolfram_row))
+	return rows_result.get("changed", false)
+
 func fill_wolfram_screen() -> void:
 	if grid_size.y <= 0:
 		return
+	settle_wolfram_scroll()
 	if wolfram_row <= 0:
 		wolfram_row = 1
 	var remaining: int = max(0, grid_size.y - wolfram_row)
-	for _i in range(remaining):
-		step_wolfram_with_workers(false, false)
+	if not step_wolfram_native(remaining, false, 0):
+		if native_automata != null and native_automata.has_method("step_wolfram_rows"):
+			var native_result: Dictionary = native_automata.call("step_wolfram_rows", grid, grid_size, wolfram_rule, wolfram_row, remaining, edge_mode, false)
+			if native_result.has("grid") and native_result["grid"] is PackedByteArray:
+				grid = native_result["grid"]
+			wolfram_row = int(native_result.get("row", wolfram_row))
+		else:
+			for _i in range(remaining):
+				step_wolfram_with_workers(false, false)
 	wolfram_enabled = false
 	wolfram_accumulator = 0.0
 	request_render()
 
+func ant_count() -> int:
+	if native_ants != null:
+		return int(native_ants.call("get_count"))
+	return ants.size()
+
+func turmite_count() -> int:
+	if native_turmites != null:
+		return int(native_turmites.call("get_count"))
+	return turmites.size()
+
 func step_ants() -> void:
+	settle_wolfram_scroll()
+	if native_ants != null:
+		# The walkers stay in the store; only the grid crosses over.
+		var walker_result: Dictionary = native_ants.call("step_ants", grid, grid_size, edge_mode)
+		if walker_result.has("grid") and walker_result["grid"] is PackedByteArray:
+			grid = walker_result["grid"]
+		if walker_result.get("changed", true):
+			request_render()
+		return
 	if native_automata != null and native_automata.has_method("step_ants"):
 		var native_result: Dictionary = native_automata.call("step_ants", grid, grid_size, edge_mode, ants, ant_directions, ant_colors)
 		if native_result.has("grid") and native_result["grid"] is PackedByteArray:
@@ -1868,9 +2080,33 @@ func step_day_night() -> void:
 func step_seeds() -> void:
 	step_totalistic([2], [])
 
+func step_totalistic_generations(birth: Array[int], survive: Array[int], generations: int) -> void:
+	settle_wolfram_scroll()
+	if generations > 1 and native_automata != null and native_automata.has_method("run_totalistic_for"):
+		# Runs as many of the owed generations as fit in the frame budget.
+		var budget_result: Dictionary = native_automata.call("run_totalistic_for", grid, grid_size, birth, survive, edge_mode, SIM_STEP_BUDGET_USEC, generations)
+		if budget_result.has("grid") and budget_result["grid"] is PackedByteArray:
+			grid = budget_result["grid"]
+			if budget_result.get("changed", true):
+				request_render()
+			return
+	if generations > 1 and native_automata != null and native_automata.has_method("step_totalistic_n"):
+		var native_result: Dictionary = native_automata.call("step_totalistic_n", grid, grid_size, birth, survive, edge_mode, generations)
+		if native_result.has("grid") and native_result["grid"] is PackedByteArray:
+			grid = native_result["grid"]
+			if native_result.get("changed", true):
+				request_render()
+			return
+	for _i in range(generations):
+		step_totalistic(birth, survive)
+
 func step_totalistic(birth: Array[int], survive: Array[int]) -> void:
+	settle_wolfram_scroll()
 	if native_automata != null and native_automata.has_method("step_totalistic"):
-		var native_result: Dictionary = native_automata.call("step_totalistic", grid, grid_size, birth, survive, edge_mode)
+		# The activity-tracking stepper skips settled regions; it falls back to a full step on its own
+		# whenever the rule, edge mode or grid size changes.
+		var method: String = "step_totalistic_active" if native_automata.has_method("step_totalistic_active") else "step_totalistic"
+		var native_result: Dictionary = native_automata.call(method, grid, grid_size, birth, survive, edge_mode)
 		if native_result.has("grid") and native_result["grid"] is PackedByteArray:
 			grid = native_result["grid"]
 			if native_result.get("changed", true):
@@ -1913,6 +2149,10 @@ func step_totalistic(birth: Array[int], survive: Array[int]) -> void:
 func spawn_turmites(count: int, color: Color) -> void:
 	var rng: RandomNumberGenerator = RandomNumberGenerator.new()
 	rng.randomize()
+	if native_turmites != null:
+		native_turmites.call("spawn_random", count, grid_size, color, rng.randi())
+		request_render()
+		return
 	for _i in range(count):
 		turmites.append(Vector2i(rng.randi_range(0, grid_size.x - 1), rng.randi_range(0, grid_size.y - 1)))
 		turmite_directions.append(rng.randi_range(0, DIRS.size() - 1))
@@ -1921,6 +2161,8 @@ func spawn_turmites(count: int, color: Color) -> void:
 	request_render()
 
 func clear_turmites() -> void:
+	if native_turmites != null:
+		native_turmites.call("clear")
 	turmites.clear()
 	turmite_directions.clear()
 	turmite_colors.clear()
@@ -1929,6 +2171,11 @@ func clear_turmites() -> void:
 	request_render()
 
 func remove_ants_at(pos: Vector2i) -> bool:
+	if native_ants != null:
+		var removed_count: int = native_ants.call("remove_at", pos)
+		if removed_count > 0 and ant_count() == 0:
+			ant_accumulator = 0.0
+		return removed_count > 0
 	var removed: bool = false
 	var i: int = ants.size() - 1
 	while i >= 0:
@@ -1943,6 +2190,11 @@ func remove_ants_at(pos: Vector2i) -> bool:
 	return removed
 
 func remove_turmites_at(pos: Vector2i) -> bool:
+	if native_turmites != null:
+		var removed_count: int = native_turmites.call("remove_at", pos)
+		if removed_count > 0 and turmite_count() == 0:
+			turmite_accumulator = 0.0
+		return removed_count > 0
 	var removed: bool = false
 	var i: int = turmites.size() - 1
 	while i >= 0:
@@ -1959,6 +2211,14 @@ func remove_turmites_at(pos: Vector2i) -> bool:
 	return removed
 
 func step_turmites(use_workers: bool = true) -> void:
+	settle_wolfram_scroll()
+	if native_turmites != null:
+		var walker_result: Dictionary = native_turmites.call("step_turmites", grid, grid_size, edge_mode, turmite_rule)
+		if walker_result.has("grid") and walker_result["grid"] is PackedByteArray:
+			grid = walker_result["grid"]
+		if walker_result.get("changed", true):
+			request_render()
+		return
 	if native_automata != null and native_automata.has_method("step_turmites"):
 		var native_result: Dictionary = native_automata.call("step_turmites", grid, grid_size, edge_mode, turmites, turmite_directions, turmite_colors, turmite_rules)
 		if native_result.has("grid") and native_result["grid"] is PackedByteArray:
@@ -2057,8 +2317,29 @@ func step_sand() -> void:
 	if sand_grid.size() != grid_size.x * grid_size.y:
 		sand_grid.resize(grid_size.x * grid_size.y)
 		sand_grid.fill(0)
+	if native_sandpile != null:
+		# The engine keeps its worklist between calls and only reloads the grid after script edits,
+		# so a settled pile costs one check per step.
+		native_sandpile.call("set_rule", sand_threshold, sand_neighborhood)
+		native_sandpile.call("sync_grid", sand_grid, grid_size, edge_mode)
+		if native_sandpile.call("is_stable"):
+			return
+		var pile_result: Dictionary = native_sandpile.call("relax", SAND_RELAX_BUDGET)
+		sand_grid = native_sandpile.call("get_grid")
+		sand_has_content = sand_grid_has_content()
+		if pile_result.get("changed", false):
+			request_render()
+		return
+	if native_automata != null and native_automata.has_method("relax_sand"):
+		var relax_result: Dictionary = native_automata.call("relax_sand", sand_grid, grid_size, edge_mode, SAND_RELAX_BUDGET, sand_threshold, sand_neighborhood)
+		if relax_result.has("grid") and relax_result["grid"] is PackedInt32Array:
+			sand_grid = relax_result["grid"]
+			sand_has_content = sand_grid_has_content()
+			if relax_result.get("changed", false):
+				request_render()
+			return
 	if native_automata != null and native_automata.has_method("step_sand"):
-		var native_result: Dictionary = native_automata.call("step_sand", sand_grid, grid_size, edge_mode)
+		var native_result: Dictionary = native_automata.call("step_sand", sand_grid, grid_size, edge_mode, sand_threshold, sand_neighborhood)
 		if native_result.has("grid") and native_result["grid"] is PackedInt32Array:
 			sand_grid = native_result["grid"]
 			sand_has_content = sand_grid_has_content()
@@ -2066,7 +2347,7 @@ func step_sand() -> void:
 				request_render()
 			return
 	if not _sim_busy("sand"):
-		var args: Array = [sand_grid.duplicate(), grid_size, edge_mode]
+		var args: Array = [sand_grid.duplicate(), grid_size, edge_mode, sand_threshold, sand_neighborhood]
 		if _enqueue_sim_task("sand", Callable(self, "sim_job_sand"), args):
 			return
 
@@ -2074,16 +2355,17 @@ func step_sand() -> void:
 	for y in range(grid_size.y):
 		for x in range(grid_size.x):
 			var idx: int = y * grid_size.x + x
-			if sand_grid[idx] >= 4:
+			if sand_grid[idx] >= sand_threshold:
 				updates.append(Vector2i(x, y))
 	if updates.is_empty():
 		sand_has_content = sand_grid_has_content()
 		return
 
+	var dirs: Array[Vector2i] = MOORE_DIRS if sand_neighborhood == SAND_MOORE else DIRS
 	for pos in updates:
 		var idx: int = pos.y * grid_size.x + pos.x
-		sand_grid[idx] -= 4
-		for dir in DIRS:
+		sand_grid[idx] -= sand_threshold
+		for dir in dirs:
 			var next: Vector2i = pos + dir
 			match edge_mode:
 				EDGE_WRAP:
@@ -2112,9 +2394,15 @@ func build_grid_image_from_data(size: Vector2i, data: PackedByteArray) -> Image:
 
 func build_sand_image_from_data(size: Vector2i, data: PackedInt32Array, palette: Array[Color]) -> Dictionary:
 	var img: Image = Image.create(size.x, size.y, false, Image.FORMAT_R8)
+	var palette_size: int = max(1, palette.size())
+	if native_automata != null and native_automata.has_method("encode_sand_levels"):
+		var native_result: Dictionary = native_automata.call("encode_sand_levels", data, size, palette_size)
+		var levels: PackedByteArray = native_result.get("levels", PackedByteArray())
+		if levels.size() == size.x * size.y:
+			img.set_data(size.x, size.y, false, Image.FORMAT_R8, levels)
+			return {"image": img, "has_content": bool(native_result.get("has_content", false))}
 	var bytes: PackedByteArray = PackedByteArray()
 	bytes.resize(size.x * size.y)
-	var palette_size: int = max(1, palette.size())
 	var has_content: bool = false
 	var data_size: int = data.size()
 	for i in range(bytes.size()):
@@ -2130,8 +2418,12 @@ func build_sand_image_from_data(size: Vector2i, data: PackedInt32Array, palette:
 	img.set_data(size.x, size.y, false, Image.FORMAT_R8, bytes)
 	return {"image": img, "has_content": has_content}
 
-func build_overlay_image_from_data(size: Vector2i, ant_pos: Array[Vector2i], ant_cols: Array[Color], turmite_pos: Array[Vector2i], turmite_cols: Array[Color]) -> Image:
-	var img: Image = Image.create(size.x, size.y, false, Image.FORMAT_RGBA8)
+func build_overlay_image_from_data(size: Vector2i, ant_pos: Array[Vector2i], ant_cols: Array[Color], turmite_pos: Array[Vector2i], turmite_cols: Array[Color], walker_rgba: PackedByteArray = PackedByteArray()) -> Image:
+	var img: Image
+	if walker_rgba.size() == size.x * size.y * 4:
+		img = Image.create_from_data(size.x, size.y, false, Image.FORMAT_RGBA8, walker_rgba)
+	else:
+		img = Image.create(size.x, size.y, false, Image.FORMAT_RGBA8)
 	for i in range(ant_pos.size()):
 		var pos: Vector2i = ant_pos[i]
 		if pos.x >= 0 and pos.x < size.x and pos.y >= 0 and pos.y < size.y:
@@ -2146,14 +2438,23 @@ func capture_render_state() -> Dictionary:
 	return {
 		"grid_size": grid_size,
 		"grid": grid,
+		"state_row_offset": wolfram_row_offset(),
 		"sand_grid": sand_grid.duplicate(),
 		"sand_colors": sand_colors.duplicate(true),
 		"ants": ants.duplicate(true),
 		"ant_colors": ant_colors.duplicate(true),
 		"turmites": turmites.duplicate(true),
 		"turmite_colors": turmite_colors.duplicate(true),
+		"walker_overlay": paint_walker_overlay(),
 	}
 
+# RGBA8 image of the NativeWalkers ants with turmites on top, painted in one native call; empty
+# without the stores or walkers, so the render task creates the blank image itself.
+func paint_walker_overlay() -> PackedByteArray:
+	if native_ants == null:
+		return PackedByteArray()
+	return native_ants.call("paint_overlay", grid_size, native_turmites)
+
 func build_render_component(params: Dictionary, component: String) -> Dictionary:
 	var size: Vector2i = params.get("grid_size", Vector2i.ZERO)
 	var grid_data: PackedByteArray = params.get("grid", PackedByteArray())
@@ -2163,16 +2464,18 @@ func build_render_component(params: Dictionary, component: String) -> Dictionary
 	var ant_cols: Array = params.get("ant_colors", [])
 	var turmite_pos: Array = params.get("turmites", [])
 	var turmite_cols: Array = params.get("turmite_colors", [])
+	var walker_rgba: PackedByteArray = params.get("walker_overlay", PackedByteArray())
 
 	var result: Dictionary = {}
 	if component == "grid":
 		result[component] = build_grid_image_from_data(size, grid_data)
+		result["state_row_offset"] = params.get("state_row_offset", 0)
 	elif component == "sand":
 		var sand_render: Dictionary = build_sand_image_from_data(size, sand_data, palette)
 		result[component] = sand_render.get("image", null)
 		result["sand_has_content"] = sand_render.get("has_content", false)
 	elif component == "overlay":
-		result[component] = build_overlay_image_from_data(size, ant_pos, ant_cols, turmite_pos, turmite_cols)
+		result[component] = build_overlay_image_from_data(size, ant_pos, ant_cols, turmite_pos, turmite_cols, walker_rgba)
 
 	render_task_mutex.lock()
 	for key in result.keys():
@@ -2215,6 +2518,8 @@ func apply_render_result(result: Dictionary) -> void:
 		grid_view.texture = state_texture
 	if grid_material.shader != null:
 		grid_material.set_shader_parameter("state_tex", state_texture)
+		if result.has("state_row_offset"):
+			grid_material.set_shader_parameter("state_row_offset", int(result["state_row_offset"]))
 		grid_material.set_shader_parameter("sand_tex", sand_texture)
 		grid_material.set_shader_parameter("overlay_tex", overlay_texture)
 		grid_material.set_shader_parameter("alive_color", alive_color)
@@ -2341,6 +2646,8 @@ func export_grid_image(path: String) -> void:
 	if grid_size.x <= 0 or grid_size.y <= 0:
 		set_info_label_text("Export failed (empty grid)")
 		return
+	# build_export_image writes rows in storage order, which a scrolled sweep has rotated.
+	settle_wolfram_scroll()
 	render_grid_sync()
 	var img: Image = build_export_image()
 	img.resize(grid_size.x * cell_size, grid_size.y * cell_size, Image.INTERPOLATE_NEAREST)
@@ -2372,6 +2679,7 @@ func build_export_image() -> Image:
 	var palette_size: int = max(1, sand_colors.size())
 	var sand_visible: bool = sand_enabled or sand_has_content
 	var overlay_map: Dictionary = {}
+	var walker_rgba: PackedByteArray = paint_walker_overlay()
 	for i in range(ants.size()):
 		overlay_map[ants[i]] = ant_colors[i]
 	for i in range(turmites.size()):
@@ -2388,6 +2696,8 @@ func build_export_image() -> Image:
 			var pos: Vector2i = Vector2i(x, y)
 			if overlay_map.has(pos):
 				color = overlay_map[pos]
+			elif walker_rgba.size() > idx * 4 + 3 and walker_rgba[idx * 4 + 3] > 0:
+				color = Color8(walker_rgba[idx * 4], walker_rgba[idx * 4 + 1], walker_rgba[idx * 4 + 2], walker_rgba[idx * 4 + 3])
 			img.set_pixel(x, y, color)
 	return img
 
@@ -3505,22 +3815,23 @@ static func sim_job_turmites(grid_in: PackedByteArray, grid_size_in: Vector2i, e
 			next_colors.append(Color.WHITE)
 	return {"grid": next_grid, "ants": next_ants, "directions": next_dirs, "colors": next_colors, "changed": changed}
 
-static func sim_job_sand(grid_in: PackedInt32Array, grid_size_in: Vector2i, edge_mode_in: int) -> Dictionary:
+static func sim_job_sand(grid_in: PackedInt32Array, grid_size_in: Vector2i, edge_mode_in: int, threshold_in: int, neighborhood_in: int) -> Dictionary:
 	if grid_size_in.x <= 0 or grid_size_in.y <= 0 or grid_in.size() != grid_size_in.x * grid_size_in.y:
 		return {"grid": grid_in, "changed": false}
 	var updates: Array[Vector2i] = []
 	for y in range(grid_size_in.y):
 		for x in range(grid_size_in.x):
 			var idx: int = y * grid_size_in.x + x
-			if grid_in[idx] >= 4:
+			if grid_in[idx] >= threshold_in:
 				updates.append(Vector2i(x, y))
 	if updates.is_empty():
 		return {"grid": grid_in, "changed": false}
 	var next: PackedInt32Array = grid_in
+	var dirs: Array[Vector2i] = MOORE_DIRS if neighborhood_in == SAND_MOORE else DIRS
 	for pos in updates:
 		var idx: int = pos.y * grid_size_in.x + pos.x
-		next[idx] -= 4
-		for dir in DIRS:
+		next[idx] -= threshold_in
+		for dir in dirs:
 			var npos: Vector2i = pos + dir
 			match edge_mode_in:
 				EDGE_WRAP: